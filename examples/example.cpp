@@ -1,5 +1,11 @@
 #include "fastexec/exec.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
 // 基础异步接口
 void base_demo() {
   auto f1 = fastexec::spawn([]() { fastlog::console.info("hello world"); });
@@ -24,14 +30,284 @@ void parallel_submit_demo() {
   fastlog::console.info("wait result: {}, {}, {}, {:}", r1, r2, r3, r5);
 }
 
-// 模拟带阻塞并行任务
+// 批量创建任务：整批任务一次入队
+void batch_submit_demo() {
+  auto futs = fastexec::spawn_n(8, [](std::size_t i) { return i * i; });
+  std::size_t sum = 0;
+  for (auto& f : futs) sum += f.get();
+  auto words = std::vector<std::string>{"fast", "exec", "batch"};
+  auto lens = fastexec::spawn_batch(
+      words, [](const std::string& w) { return w.size(); });
+  fastlog::console.info("spawn_n sum: {}, spawn_batch first len: {}", sum,
+                        lens.front().get());
+}
+
+// 独立配置的线程池实例
+void runtime_demo() {
+  auto rt = fastexec::runtime::builder()
+                .worker_threads(2)
+                .queue_capacity(64)
+                .thread_name("demo")
+                .build();
+  auto f = rt.spawn([](int a, int b) { return a + b; }, 1, 2);
+  fastlog::console.info("runtime result {}", f.get());
+  rt.block_on([&rt]() {
+    rt.spawn([]() { fastlog::console.info("runtime child task"); });
+  });
+
+  // 有界全局队列：队列满时由提交线程自己执行任务
+  auto bounded = fastexec::runtime::builder()
+                     .worker_threads(1)
+                     .global_queue_capacity(8)
+                     .overflow_policy(fastexec::overflow_policy::caller_runs)
+                     .build();
+  auto results = bounded.spawn_n(64, [](std::size_t i) { return i; });
+  for (auto& r : results) r.get();
+  fastlog::console.info("bounded runtime caller_runs: {}",
+                        bounded.overflow_stats().caller_runs);
+
+  // 编译期调度策略：小容量本地队列，任务更快地分散到其他 worker
+  auto latency = fastexec::runtime::builder().worker_threads(2).build<
+      fastexec::latency_policy>();
+  auto g = latency.spawn([]() { return 7; });
+  fastlog::console.info("latency runtime result {}", g.get());
+
+  // 动态伸缩：空闲时只保留一个活跃 worker
+  auto elastic = fastexec::runtime::builder()
+                     .worker_threads(4)
+                     .scaling({.min_active = 1,
+                               .idle_timeout = std::chrono::milliseconds(10)})
+                     .build();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  fastlog::console.info("elastic runtime active workers {}",
+                        elastic.active_workers());
+
+  // 运行中调整工作线程数
+  elastic.resize(2);
+  auto h = elastic.spawn([]() { return 11; });
+  fastlog::console.info("resized runtime threads {} result {}",
+                        elastic.worker_threads(), h.get());
+
+  // 缩减到一个 worker：退役 worker 上排队的截止时间任务交给剩下的 worker
+  auto shrink = fastexec::runtime::builder().worker_threads(4).build();
+  std::vector<std::future<void>> deadlines;
+  std::atomic<int> deadline_done{0};
+  // 其他 worker 也在忙，来不及窃取 3 号 worker 的截止时间任务
+  std::vector<std::future<void>> others;
+  for (std::size_t id = 0; id < 3; ++id) {
+    others.push_back(shrink.spawn_on(id, []() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }));
+  }
+  auto busy = shrink.spawn_on(3, [&]() {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    for (int i = 0; i < 8; ++i) {
+      deadlines.push_back(
+          shrink.spawn_with_deadline(deadline, [&]() { ++deadline_done; }));
+    }
+    // 3 号 worker 忙碌期间被要求退役，截止时间任务还在它的队列中
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  shrink.resize(1);
+  busy.get();
+  for (auto& o : others) o.get();
+  for (auto& d : deadlines) d.get();
+  fastlog::console.info("shrunk runtime deadline tasks done {}",
+                        deadline_done.load());
+
+  // 关闭后丢弃排队中的任务，再重新启动同一个线程池
+  auto slow = elastic.spawn_n(64, [](std::size_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  elastic.shutdown(fastexec::shutdown_mode::abort);
+  std::size_t dropped = 0;
+  for (auto& r : slow) {
+    try {
+      r.get();
+    } catch (const std::runtime_error&) {
+      ++dropped;
+    }
+  }
+  elastic.restart();
+  fastlog::console.info("restarted runtime dropped {} result {}", dropped,
+                        elastic.spawn([]() { return 13; }).get());
+}
+
+// 定时任务：延迟执行、周期执行和取消
+void timer_demo() {
+  using namespace std::chrono_literals;
+  fastexec::spawn_after(10ms, []() { fastlog::console.info("timer fired"); });
+  auto ticker = fastexec::spawn_every(
+      20ms, []() { fastlog::console.info("periodic timer tick"); });
+  std::this_thread::sleep_for(70ms);
+  ticker.cancel();
+}
+
+// 协程等待 fd 就绪：等待期间不占用 worker
+fastexec::task<std::string> read_pipe(int fd) {
+  co_await fastexec::readable(fd);
+  char buf[64]{};
+  auto n = ::read(fd, buf, sizeof(buf));
+  co_return std::string(buf, n > 0 ? static_cast<std::size_t>(n) : 0);
+}
+
+void reactor_demo() {
+  int fds[2];
+  if (::pipe2(fds, O_NONBLOCK) != 0) return;
+  auto message = fastexec::co_spawn(read_pipe(fds[0]));
+  fastexec::spawn_after(std::chrono::milliseconds(10),
+                        [fd = fds[1]]() { ::write(fd, "ping", 4); });
+  fastlog::console.info("pipe message: {}", message.get());
+  fastexec::release_fd(fds[0]);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+// 通道：生产者和消费者协程通过有界通道传递数据，满或空时只挂起协程
+fastexec::task<void> produce(fastexec::channel<int>& ch, int count) {
+  for (int i = 1; i <= count; ++i) {
+    co_await ch.send(i);
+  }
+}
+
+fastexec::task<long> consume(fastexec::channel<int>& ch) {
+  long sum = 0;
+  while (auto value = co_await ch.recv()) {
+    sum += *value;
+  }
+  co_return sum;
+}
+
+void channel_demo() {
+  fastexec::channel<int> ch(4);
+  auto sum = fastexec::co_spawn(consume(ch));
+  auto p1 = fastexec::co_spawn(produce(ch, 50));
+  auto p2 = fastexec::co_spawn(produce(ch, 50));
+  p1.get();
+  p2.get();
+  ch.close();
+  fastlog::console.info("channel sum: {}", sum.get());
+}
+
+// 观察通道下发关闭信号，一次性通道返回结果
+fastexec::task<void> stoppable_worker(fastexec::watch<bool>::Receiver stop,
+                                      fastexec::oneshot_sender<int> result) {
+  int rounds = 0;
+  while (co_await stop.changed()) {
+    ++rounds;
+    if (stop.get()) break;
+  }
+  result.send(rounds);
+}
+
+void signal_demo() {
+  fastexec::watch<bool> stop(false);
+  auto [tx, rx] = fastexec::oneshot<int>();
+  auto done =
+      fastexec::co_spawn(stoppable_worker(stop.subscribe(), std::move(tx)));
+  stop.send(true);
+  fastlog::console.info("worker stopped after {} signal(s)", *rx.get());
+  done.get();
+}
+
+// 协程同步原语：锁竞争时挂起协程，不阻塞 worker
+fastexec::task<void> add_under_lock(fastexec::async_mutex& mutex,
+                                    fastexec::async_latch& done, long& total,
+                                    int value) {
+  {
+    auto guard = co_await mutex.scoped_lock();
+    total += value;
+  }
+  done.count_down();
+}
+
+fastexec::task<long> sync_demo_task() {
+  fastexec::async_mutex mutex;
+  fastexec::async_latch done(100);
+  long total = 0;
+  for (int i = 1; i <= 100; ++i) {
+    fastexec::co_spawn(add_under_lock(mutex, done, total, i));
+  }
+  co_await done.wait();
+  co_return total;
+}
+
+void sync_demo() {
+  fastlog::console.info("async mutex total: {}",
+                        fastexec::co_spawn(sync_demo_task()).get());
+}
+
+// 协作式让出：长循环中定期让出 worker，其他任务可以插进来执行
+fastexec::task<long> long_loop() {
+  long sum = 0;
+  for (long i = 0; i < 100000; ++i) {
+    sum += i;
+    if (i % 10000 == 0) co_await fastexec::yield_now();
+  }
+  co_return sum;
+}
+
+void yield_demo() {
+  fastlog::console.info("long loop sum: {}",
+                        fastexec::co_spawn(long_loop()).get());
+}
+
+// 按 worker 分片计数：每个分片只在对应的 worker 上修改，不需要加锁
+void shard_demo() {
+  auto rt = fastexec::runtime::builder().worker_threads(4).build();
+  std::vector<long> shards(rt.worker_threads(), 0);
+  rt.block_on([&] {
+    for (std::size_t n = 0; n < 1000; ++n) {
+      auto i = n % shards.size();
+      rt.spawn_on(i, [&shards, i] { ++shards[i]; });
+    }
+  });
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    fastlog::console.info("shard {}: {}", i, shards[i]);
+  }
+
+  // worker 局部存储：每个 worker 不加锁地累加自己的计数，结束后合并
+  fastexec::worker_local<long> counts{rt};
+  rt.block_on([&] {
+    for (std::size_t n = 0; n < 1000; ++n) {
+      rt.spawn([&counts, n] { counts.local() += static_cast<long>(n); });
+    }
+  });
+  fastlog::console.info("worker_local sum {} over {} workers",
+                        counts.combine(std::plus<>{}), counts.size());
+}
+
+// 协程读写文件：Linux 上使用 io_uring，否则在阻塞任务线程中执行
+fastexec::task<std::int64_t> file_roundtrip(int fd) {
+  auto buf = fastexec::acquire_buffer();
+  std::string_view text = "hello io_uring";
+  std::memcpy(buf.data().data(), text.data(), text.size());
+  auto data = buf.data().first(text.size());
+  auto written = co_await fastexec::write_at(fd, data, 0);
+  if (written < 0) co_return written;
+  co_return co_await fastexec::read_at(fd, data, 0);
+}
+
+void file_demo() {
+  char path[] = "/tmp/fastexecXXXXXX";
+  int fd = ::mkstemp(path);
+  if (fd < 0) return;
+  auto n = fastexec::co_spawn(file_roundtrip(fd)).get();
+  fastlog::console.info("file roundtrip read {} bytes", n);
+  ::unlink(path);
+  ::close(fd);
+}
+
+// 模拟带阻塞并行任务，阻塞任务交给阻塞任务线程执行，不占用 worker
 void demo1_task() {
   fastexec::spawn([]() { fastlog::console.info("demo1_task first ..."); });
-  fastexec::spawn([]() {
+  fastexec::spawn_blocking([]() {
     fastlog::console.info("demo1_task second ...");
     std::this_thread::sleep_for(std::chrono::seconds(1));
   });
-  fastexec::spawn([]() {
+  fastexec::spawn_blocking([]() {
     fastlog::console.info("demo1_task third ...");
     std::this_thread::sleep_for(std::chrono::seconds(2));
   });
@@ -62,6 +338,26 @@ int main() {
   base_demo();
   fastlog::console.info("parallel_submit_demo ...........................");
   parallel_submit_demo();
+  fastlog::console.info("batch_submit_demo ...........................");
+  batch_submit_demo();
+  fastlog::console.info("runtime_demo ...........................");
+  runtime_demo();
+  fastlog::console.info("timer_demo ...........................");
+  timer_demo();
+  fastlog::console.info("reactor_demo ...........................");
+  reactor_demo();
+  fastlog::console.info("channel_demo ...........................");
+  channel_demo();
+  fastlog::console.info("signal_demo ...........................");
+  signal_demo();
+  fastlog::console.info("sync_demo ...........................");
+  sync_demo();
+  fastlog::console.info("yield_demo ...........................");
+  yield_demo();
+  fastlog::console.info("shard_demo ...........................");
+  shard_demo();
+  fastlog::console.info("file_demo ...........................");
+  file_demo();
   fastlog::console.info("demo1_task start...................................");
   fastexec::block_on(std::move(demo1_task));
   fastlog::console.info("demo1_task finish...................................");
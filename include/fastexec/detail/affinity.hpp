@@ -0,0 +1,106 @@
+#ifndef __FASTSTDEXEC_DETAIL_AFFINITY_HPP
+#define __FASTSTDEXEC_DETAIL_AFFINITY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "fastlog/fastlog.hpp"
+#include "topology.hpp"
+namespace fastexec::detail {
+// 工作线程的 CPU 亲和性策略
+enum class AffinityPolicy {
+  none,     // 不绑定，由内核自由调度
+  compact,  // 按拓扑顺序依次绑定，相邻 worker 共享核心、L3 和节点
+  scatter,  // 轮流分散到不同节点、不同 L3、不同核心，最后才使用 SMT 兄弟
+  list,     // 按显式给出的 CPU 列表绑定
+};
+
+// 计算每个 worker 的 CPU 位置
+// none 和 compact 使用拓扑顺序，list 使用 cpu_list，worker 数超过 CPU
+// 数时循环使用；list 的 cpu_list 为空时记录警告并按 compact 排布
+inline std::vector<CpuInfo> place_workers(const Topology& topology,
+                                          std::size_t worker_count,
+                                          AffinityPolicy policy,
+                                          std::span<const int> cpu_list) {
+  std::vector<CpuInfo> order;
+  auto cpus = topology.cpus();
+  if (policy == AffinityPolicy::list && cpu_list.empty()) {
+    fastlog::console.warn(
+        "affinity policy list with an empty cpu list, falling back to compact");
+  }
+  if (policy == AffinityPolicy::list && !cpu_list.empty()) {
+    for (auto cpu : cpu_list) {
+      auto it = std::ranges::find(cpus, cpu, &CpuInfo::cpu);
+      order.push_back(it != cpus.end() ? *it : CpuInfo{cpu, cpu, cpu, 0});
+    }
+  } else if (policy == AffinityPolicy::scatter) {
+    // 计算每个 CPU 在核心内、核心在 L3 内、L3 在节点内的序号，
+    // 按 (SMT 序号, 核心序号, L3 序号, 节点) 排序即可轮流分散
+    using key_type = std::tuple<int, int, int, std::size_t>;
+    std::map<int, int> core_rank, l3_rank, cores_in_l3, l3s_in_node;
+    std::vector<std::pair<key_type, CpuInfo>> keys;
+    for (auto& c : cpus) {
+      auto smt = static_cast<int>(std::ranges::count_if(
+          cpus, [&](auto& o) { return o.core == c.core && o.cpu < c.cpu; }));
+      if (!core_rank.contains(c.core)) {
+        core_rank[c.core] = cores_in_l3[c.l3]++;
+      }
+      if (!l3_rank.contains(c.l3)) {
+        l3_rank[c.l3] = l3s_in_node[c.node]++;
+      }
+      keys.emplace_back(key_type{smt, core_rank[c.core], l3_rank[c.l3],
+                                 topology.node_index(c.node)},
+                        c);
+    }
+    std::ranges::sort(keys, {}, &std::pair<key_type, CpuInfo>::first);
+    for (auto& [key, c] : keys) {
+      order.push_back(c);
+    }
+  } else {
+    order.assign(cpus.begin(), cpus.end());
+  }
+
+  std::vector<CpuInfo> placement(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    placement[i] = order[i % order.size()];
+  }
+  return placement;
+}
+
+// 将当前线程绑定到指定 CPU，返回是否成功
+inline bool bind_current_thread_to_cpu(int cpu) {
+#ifdef __linux__
+  if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+// 设置当前线程的名字，Linux 下最多 15 个字符，超出部分截断
+inline void set_current_thread_name(std::string_view name) {
+#ifdef __linux__
+  std::string truncated{name.substr(0, 15)};
+  pthread_setname_np(pthread_self(), truncated.c_str());
+#else
+  (void)name;
+#endif
+}
+}  // namespace fastexec::detail
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef __FASTSTDEXEC_DETAIL_BLOCKING_HPP
+#define __FASTSTDEXEC_DETAIL_BLOCKING_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "affinity.hpp"
+#include "taskgroup.hpp"
+#include "util.hpp"
+namespace fastexec::detail {
+// 阻塞任务线程池：执行会阻塞线程的任务(sleep、文件读写、等锁等)，
+// 避免它们占用固定数量的 worker，饿死计算型任务
+// 线程数是弹性的：没有空闲线程时按需创建(不超过上限)，
+// 线程空闲超过 keep_alive 后自动退出
+class BlockingPool : util::noncopyable {
+ public:
+  BlockingPool(std::size_t max_threads, std::chrono::milliseconds keep_alive,
+               std::string thread_name)
+      : _max_threads(std::max<std::size_t>(1, max_threads)),
+        _keep_alive(keep_alive),
+        _thread_name(std::move(thread_name)) {}
+
+  // 关闭并等待所有线程执行完剩余任务后退出
+  ~BlockingPool() {
+    close();
+    join();
+  }
+
+ public:
+  // 提交任务，没有空闲线程且未达到上限时创建新线程
+  void submit(std::function<void()> task) {
+    std::lock_guard lock{_mutex};
+    if (_closed) throw std::runtime_error{"queue is closed"};
+    _queue.push_back(std::move(task));
+    if (_idle_count >= _queue.size() || _thread_count >= _max_threads) {
+      _cv.notify_one();
+    } else {
+      spawn_thread();
+    }
+  }
+
+  // 关闭线程池，已提交的任务仍会执行完
+  void close() {
+    std::lock_guard lock{_mutex};
+    _closed = true;
+    _cv.notify_all();
+  }
+
+  // 关闭线程池并丢弃还没有开始执行的任务，其 future 得到异常
+  void abort() {
+    std::deque<std::function<void()>> dropped;
+    {
+      std::lock_guard lock{_mutex};
+      _closed = true;
+      dropped.swap(_queue);
+      _cv.notify_all();
+    }
+    for (auto& task : dropped) {
+      discard_task(task);
+    }
+  }
+
+  // 重新打开已经关闭的线程池(需要先 join)
+  void reopen() {
+    std::lock_guard lock{_mutex};
+    _closed = false;
+  }
+
+  // 等待所有线程退出(需要先 close)
+  void join() {
+    std::unique_lock lock{_mutex};
+    _exit_cv.wait(lock, [this]() { return _thread_count == 0; });
+  }
+
+  // 最多等待到 deadline，返回所有线程是否都已退出
+  template <typename Clock, typename Duration>
+  bool join_until(std::chrono::time_point<Clock, Duration> deadline) {
+    std::unique_lock lock{_mutex};
+    return _exit_cv.wait_until(lock, deadline,
+                               [this]() { return _thread_count == 0; });
+  }
+
+  // 当前线程数
+  [[nodiscard]]
+  std::size_t thread_count() const {
+    std::lock_guard lock{_mutex};
+    return _thread_count;
+  }
+
+ private:
+  // 创建一个新线程(调用方持有锁)，线程分离运行，退出时递减计数
+  void spawn_thread() {
+    ++_thread_count;
+    auto id = _next_thread_id++;
+    std::thread([this, id]() {
+      set_current_thread_name(_thread_name + "-b" + std::to_string(id));
+      run();
+    }).detach();
+  }
+
+  void run() {
+    std::unique_lock lock{_mutex};
+    while (true) {
+      if (!_queue.empty()) {
+        auto task = std::move(_queue.front());
+        _queue.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        continue;
+      }
+      if (_closed) break;
+      // 空闲等待新任务，超过 keep_alive 仍没有任务则退出
+      ++_idle_count;
+      auto woken = _cv.wait_for(lock, _keep_alive, [this]() {
+        return !_queue.empty() || _closed;
+      });
+      --_idle_count;
+      if (!woken) break;
+    }
+    // 在锁内完成最后的通知，解锁后不再访问 this
+    if (--_thread_count == 0) {
+      _exit_cv.notify_all();
+    }
+  }
+
+ private:
+  mutable std::mutex _mutex{};                 // 保护以下所有状态
+  std::condition_variable _cv{};               // 通知空闲线程有新任务
+  std::condition_variable _exit_cv{};          // 通知线程全部退出
+  std::deque<std::function<void()>> _queue{};  // 任务队列
+  std::size_t _max_threads;                    // 线程数上限
+  std::chrono::milliseconds _keep_alive;       // 空闲线程的存活时间
+  std::string _thread_name;                    // 线程名前缀
+  std::size_t _thread_count{0};                // 当前线程数
+  std::size_t _idle_count{0};                  // 空闲线程数
+  std::size_t _next_thread_id{0};              // 下一个线程的编号
+  bool _closed{false};                         // 是否关闭
+};
+}  // namespace fastexec::detail
+
+#endif
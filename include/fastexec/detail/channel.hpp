@@ -0,0 +1,922 @@
+#ifndef __FASTSTDEXEC_DETAIL_CHANNEL_HPP
+#define __FASTSTDEXEC_DETAIL_CHANNEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "util.hpp"
+#include "waiter.hpp"
+namespace fastexec::detail {
+// 有界多生产者多消费者环形队列(Vyukov)，无锁
+// 每个槽位带一个序号：序号等于 2*写位置 时可写，等于 2*写位置+1 时可读，
+// 取出后设为下一圈的可写序号(序号乘 2 使容量为 1 时可写和可读不会混淆)
+// 生产者和消费者分别用 CAS 推进 _tail 和 _head，不会互相阻塞
+template <typename T>
+class MpmcRing : util::noncopyable {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "channel element must be nothrow move constructible");
+
+ public:
+  explicit MpmcRing(std::size_t capacity)
+      : _capacity(std::max<std::size_t>(1, capacity)),
+        _cells(std::make_unique<Cell[]>(_capacity)) {
+    for (std::size_t i = 0; i < _capacity; ++i) {
+      _cells[i]._seq.store(2 * i, std::memory_order::relaxed);
+    }
+  }
+
+  // 析构剩余的元素(此时不会再有并发访问)
+  ~MpmcRing() {
+    auto tail = _tail.load(std::memory_order::relaxed);
+    for (auto pos = _head.load(std::memory_order::relaxed); pos != tail;
+         ++pos) {
+      cell(pos).value()->~T();
+    }
+  }
+
+ public:
+  [[nodiscard]]
+  std::size_t capacity() const {
+    return _capacity;
+  }
+
+  // 元素数量，并发修改时只是近似值
+  [[nodiscard]]
+  std::size_t size() const {
+    auto head = _head.load(std::memory_order::acquire);
+    auto tail = _tail.load(std::memory_order::acquire);
+    return tail > head ? std::min(tail - head, _capacity) : 0;
+  }
+
+  // 尝试放入元素，已满时返回 false，只有成功时才会移走 value
+  bool try_push(T& value) {
+    auto pos = _tail.load(std::memory_order::relaxed);
+    while (true) {
+      auto& slot = cell(pos);
+      auto seq = slot._seq.load(std::memory_order::acquire);
+      auto diff = static_cast<std::intptr_t>(seq - 2 * pos);
+      if (diff == 0) {
+        if (_tail.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order::relaxed)) {
+          ::new (static_cast<void*>(slot._storage)) T(std::move(value));
+          slot._seq.store(2 * pos + 1, std::memory_order::release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _tail.load(std::memory_order::relaxed);
+      }
+    }
+  }
+
+  // 尝试取出元素，为空时返回空
+  std::optional<T> try_pop() {
+    auto pos = _head.load(std::memory_order::relaxed);
+    while (true) {
+      auto& slot = cell(pos);
+      auto seq = slot._seq.load(std::memory_order::acquire);
+      auto diff = static_cast<std::intptr_t>(seq - (2 * pos + 1));
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order::relaxed)) {
+          std::optional<T> result{std::move(*slot.value())};
+          slot.value()->~T();
+          slot._seq.store(2 * (pos + _capacity), std::memory_order::release);
+          return result;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        pos = _head.load(std::memory_order::relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> _seq{0};              // 槽位序号
+    alignas(T) std::byte _storage[sizeof(T)]{};  // 元素存储
+
+    T* value() { return std::launder(reinterpret_cast<T*>(_storage)); }
+  };
+
+  Cell& cell(std::size_t pos) { return _cells[pos % _capacity]; }
+
+ private:
+  std::size_t _capacity;                            // 容量
+  std::unique_ptr<Cell[]> _cells;                   // 槽位
+  alignas(64) std::atomic<std::size_t> _head{0};    // 读位置
+  alignas(64) std::atomic<std::size_t> _tail{0};    // 写位置
+};
+
+// 异步有界多生产者多消费者通道
+// 元素存放在无锁环形队列中，快速路径(未满时发送、非空时接收)不加锁；
+// 通道已满或为空时，发送方或接收方的协程被挂起，不阻塞 worker 线程，
+// 有空间或数据时由对端把元素直接交给等待者，再把它的协程交回线程池恢复
+// 等待者按到达顺序排队，等待队列和等待者计数由互斥锁保护，
+// 快速路径只在等待者计数不为 0 时才加锁服务等待者
+// 关闭后不能再发送；接收方取完剩余元素后得到空值
+template <typename T>
+class Channel : util::noncopyable {
+  // 等待发送的协程：_items 中的元素按顺序放入通道，全部放入后唤醒
+  struct SendWaiter {
+    T* _items{nullptr};        // 待发送的元素
+    std::size_t _count{0};     // 待发送的元素数量
+    std::size_t _sent{0};      // 已放入通道的元素数量
+    bool _closed{false};       // 等待期间通道被关闭
+    Parked _parked{};          // 挂起的协程
+
+    // 尽量把剩余元素放入通道，返回是否放入了元素
+    bool push_into(MpmcRing<T>& ring) {
+      auto before = _sent;
+      while (_sent < _count && ring.try_push(_items[_sent])) {
+        ++_sent;
+      }
+      return _sent > before;
+    }
+    bool done() const { return _sent == _count; }
+  };
+
+  // 等待接收的协程：至少收到一个元素(或通道关闭)后唤醒
+  struct RecvWaiter {
+    std::size_t _max{1};          // 最多接收的元素数量
+    bool _batch{false};           // 是否批量接收
+    std::optional<T> _value{};    // 单个接收的结果
+    std::vector<T> _items{};      // 批量接收的结果
+    Parked _parked{};             // 挂起的协程
+
+    std::size_t received() const {
+      return _batch ? _items.size() : (_value.has_value() ? 1 : 0);
+    }
+    // 尽量从通道取出元素，返回是否取到了元素
+    bool pop_from(MpmcRing<T>& ring) {
+      auto before = received();
+      while (received() < _max) {
+        auto value = ring.try_pop();
+        if (!value) break;
+        if (_batch) {
+          _items.push_back(std::move(*value));
+        } else {
+          _value = std::move(value);
+        }
+      }
+      return received() > before;
+    }
+  };
+
+ public:
+  // co_await channel.send(value)：通道已满时挂起，通道已关闭时抛出异常
+  class SendAwaiter {
+   public:
+    SendAwaiter(Channel& channel, T value)
+        : _channel(&channel), _value(std::move(value)) {}
+
+    bool await_ready() {
+      _waiter._items = &_value;
+      _waiter._count = 1;
+      return _channel->try_send_waiter(_waiter) &&
+             !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      return _channel->park_sender(_waiter, handle);
+    }
+    void await_resume() const {
+      if (!_waiter.done()) throw std::runtime_error{"channel is closed"};
+    }
+
+   private:
+    Channel* _channel;
+    T _value;
+    SendWaiter _waiter{};
+    bool _yield{false};  // 已经完成但预算耗尽，挂起让出 worker
+  };
+
+  // co_await channel.send_batch(items)：按顺序发送全部元素，
+  // 返回发送的元素数量，通道中途关闭时小于 items.size()
+  class SendBatchAwaiter {
+   public:
+    SendBatchAwaiter(Channel& channel, std::vector<T> items)
+        : _channel(&channel), _items(std::move(items)) {}
+
+    bool await_ready() {
+      _waiter._items = _items.data();
+      _waiter._count = _items.size();
+      return _channel->try_send_waiter(_waiter) &&
+             !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      return _channel->park_sender(_waiter, handle);
+    }
+    std::size_t await_resume() const { return _waiter._sent; }
+
+   private:
+    Channel* _channel;
+    std::vector<T> _items;
+    SendWaiter _waiter{};
+    bool _yield{false};  // 已经完成但预算耗尽，挂起让出 worker
+  };
+
+  // co_await channel.recv()：通道为空时挂起，通道关闭且取完后返回空
+  class RecvAwaiter {
+   public:
+    explicit RecvAwaiter(Channel& channel) : _channel(&channel) {}
+
+    bool await_ready() {
+      return _channel->try_recv_waiter(_waiter) &&
+             !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      return _channel->park_receiver(_waiter, handle);
+    }
+    std::optional<T> await_resume() { return std::move(_waiter._value); }
+
+   private:
+    Channel* _channel;
+    RecvWaiter _waiter{};
+    bool _yield{false};  // 已经完成但预算耗尽，挂起让出 worker
+  };
+
+  // co_await channel.recv_batch(max)：至少接收一个元素，最多 max 个，
+  // 通道关闭且取完后返回空 vector
+  class RecvBatchAwaiter {
+   public:
+    RecvBatchAwaiter(Channel& channel, std::size_t max) : _channel(&channel) {
+      _waiter._max = std::max<std::size_t>(1, max);
+      _waiter._batch = true;
+    }
+
+    bool await_ready() {
+      return _channel->try_recv_waiter(_waiter) &&
+             !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      return _channel->park_receiver(_waiter, handle);
+    }
+    std::vector<T> await_resume() { return std::move(_waiter._items); }
+
+   private:
+    Channel* _channel;
+    RecvWaiter _waiter{};
+    bool _yield{false};  // 已经完成但预算耗尽，挂起让出 worker
+  };
+
+ public:
+  explicit Channel(std::size_t capacity) : _ring(capacity) {}
+
+ public:
+  // 在协程中发送，通道已满时挂起
+  [[nodiscard]]
+  SendAwaiter send(T value) {
+    return SendAwaiter{*this, std::move(value)};
+  }
+
+  // 在协程中批量发送
+  [[nodiscard]]
+  SendBatchAwaiter send_batch(std::vector<T> items) {
+    return SendBatchAwaiter{*this, std::move(items)};
+  }
+
+  // 在协程中接收，通道为空时挂起
+  [[nodiscard]]
+  RecvAwaiter recv() {
+    return RecvAwaiter{*this};
+  }
+
+  // 在协程中批量接收，最多 max 个
+  [[nodiscard]]
+  RecvBatchAwaiter recv_batch(std::size_t max) {
+    return RecvBatchAwaiter{*this, max};
+  }
+
+  // 不挂起地发送，通道已满时返回 false，通道已关闭时抛出异常
+  bool try_send(T value) {
+    if (closed()) throw std::runtime_error{"channel is closed"};
+    if (!_ring.try_push(value)) return false;
+    pump();
+    return true;
+  }
+
+  // 不挂起地接收，通道为空时返回空
+  std::optional<T> try_recv() {
+    auto value = _ring.try_pop();
+    if (value) pump();
+    return value;
+  }
+
+  // 关闭通道：之后不能再发送，唤醒所有等待者
+  // 等待发送的协程抛出异常，等待接收的协程得到空值
+  void close() {
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      if (_closed.exchange(true, std::memory_order::acq_rel)) return;
+      serve_locked(ready);
+      for (auto waiter : _senders) {
+        waiter->_closed = true;
+        ready.push_back(&waiter->_parked);
+      }
+      for (auto waiter : _receivers) {
+        ready.push_back(&waiter->_parked);
+      }
+      _senders.clear();
+      _receivers.clear();
+      _sender_count.store(0, std::memory_order::release);
+      _receiver_count.store(0, std::memory_order::release);
+    }
+    wake_all(ready);
+  }
+
+  [[nodiscard]]
+  bool closed() const {
+    return _closed.load(std::memory_order::acquire);
+  }
+
+  // 通道中的元素数量(近似值)
+  [[nodiscard]]
+  std::size_t size() const {
+    return _ring.size();
+  }
+
+  [[nodiscard]]
+  std::size_t capacity() const {
+    return _ring.capacity();
+  }
+
+ private:
+  // 快速路径发送：全部放入后不需要挂起
+  bool try_send_waiter(SendWaiter& waiter) {
+    if (closed()) {
+      waiter._closed = true;
+      return true;
+    }
+    if (waiter.push_into(_ring)) pump();
+    return waiter.done();
+  }
+
+  // 快速路径接收：取到元素，或通道已关闭时不需要挂起
+  bool try_recv_waiter(RecvWaiter& waiter) {
+    if (waiter.pop_from(_ring)) {
+      pump();
+      return true;
+    }
+    return false;
+  }
+
+  // 加锁后排到等待队列末尾，再按顺序服务一次等待者，仍未完成时挂起
+  // 先增加等待者计数再重试，与快速路径的"先操作再检查计数"配合，不会丢失唤醒
+  // 返回是否挂起；服务时已经完成的等待者不挂起，从待唤醒列表中移除
+  bool park_sender(SendWaiter& waiter, std::coroutine_handle<> handle) {
+    std::vector<Parked*> ready;
+    bool parked = false;
+    {
+      std::lock_guard lock{_mutex};
+      _sender_count.fetch_add(1, std::memory_order::seq_cst);
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      if (closed()) {
+        waiter._closed = true;
+        _sender_count.fetch_sub(1, std::memory_order::release);
+      } else {
+        _senders.push_back(&waiter);
+        serve_locked(ready);
+        parked = !waiter.done();
+        if (parked) {
+          waiter._parked = Parked{handle};
+        } else {
+          std::erase(ready, &waiter._parked);
+        }
+      }
+    }
+    wake_all(ready);
+    return parked;
+  }
+
+  // 与 park_sender 相同，通道已关闭且没有剩余元素时不挂起
+  bool park_receiver(RecvWaiter& waiter, std::coroutine_handle<> handle) {
+    std::vector<Parked*> ready;
+    bool parked = false;
+    {
+      std::lock_guard lock{_mutex};
+      _receiver_count.fetch_add(1, std::memory_order::seq_cst);
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      _receivers.push_back(&waiter);
+      serve_locked(ready);
+      if (waiter.received() > 0) {
+        std::erase(ready, &waiter._parked);
+      } else if (closed()) {
+        // 关闭时等待队列已清空，自己是唯一的等待者
+        _receivers.pop_back();
+        _receiver_count.fetch_sub(1, std::memory_order::release);
+      } else {
+        waiter._parked = Parked{handle};
+        parked = true;
+      }
+    }
+    wake_all(ready);
+    return parked;
+  }
+
+  // 放入或取出元素后调用：有等待者时加锁为它们收发元素并唤醒
+  void pump() {
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (_sender_count.load(std::memory_order::relaxed) == 0 &&
+        _receiver_count.load(std::memory_order::relaxed) == 0) {
+      return;
+    }
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      serve_locked(ready);
+    }
+    wake_all(ready);
+  }
+
+  // 按到达顺序为等待者收发元素，完成的等待者出队并追加到 ready
+  // 为发送方放入元素后可能可以满足接收方，反之亦然，所以循环到没有进展为止
+  // (调用方持有锁)
+  void serve_locked(std::vector<Parked*>& ready) {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      while (!_senders.empty()) {
+        auto waiter = _senders.front();
+        progress |= waiter->push_into(_ring);
+        if (!waiter->done()) break;
+        _senders.pop_front();
+        _sender_count.fetch_sub(1, std::memory_order::release);
+        ready.push_back(&waiter->_parked);
+      }
+      while (!_receivers.empty()) {
+        auto waiter = _receivers.front();
+        if (!waiter->pop_from(_ring)) break;
+        progress = true;
+        _receivers.pop_front();
+        _receiver_count.fetch_sub(1, std::memory_order::release);
+        ready.push_back(&waiter->_parked);
+      }
+    }
+  }
+
+  // 在锁外唤醒，被唤醒的协程可能立即在其他线程恢复
+  static void wake_all(std::vector<Parked*>& ready) {
+    for (auto parked : ready) {
+      parked->wake();
+    }
+  }
+
+ private:
+  MpmcRing<T> _ring;                            // 元素存储
+  std::mutex _mutex{};                          // 保护等待队列
+  std::deque<SendWaiter*> _senders{};           // 等待发送的协程
+  std::deque<RecvWaiter*> _receivers{};         // 等待接收的协程
+  std::atomic<std::size_t> _sender_count{0};    // 等待发送的协程数量
+  std::atomic<std::size_t> _receiver_count{0};  // 等待接收的协程数量
+  std::atomic<bool> _closed{false};             // 是否关闭
+};
+
+// 一次性通道的共享状态：只传递一个值，状态用一个原子变量表示，不需要锁
+template <typename T>
+struct OneshotState {
+  enum : std::uint8_t {
+    EMPTY,    // 还没有值，接收方没有挂起
+    WAITING,  // 接收方已挂起等待
+    READY,    // 已发送值
+    CLOSED,   // 发送方没有发送就被销毁
+  };
+
+  std::atomic<std::uint8_t> _state{EMPTY};  // 状态
+  std::optional<T> _value{};                // 发送的值
+  Parked _parked{};                         // 挂起的接收方
+};
+
+// 一次性通道的发送方：只能发送一次，没有发送就销毁时接收方得到空值
+// 比 std::promise 轻：共享状态只有一次分配，发送和接收都只有一次原子操作
+template <typename T>
+class OneshotSender {
+  using State = OneshotState<T>;
+
+ public:
+  explicit OneshotSender(std::shared_ptr<State> state)
+      : _state(std::move(state)) {}
+  OneshotSender(OneshotSender&& other) noexcept = default;
+  OneshotSender& operator=(OneshotSender&& other) noexcept {
+    if (this != &other) {
+      close();
+      _state = std::move(other._state);
+    }
+    return *this;
+  }
+  ~OneshotSender() { close(); }
+
+ public:
+  // 发送值并唤醒接收方，重复发送时抛出异常
+  void send(T value) {
+    if (!_state) throw std::runtime_error{"oneshot is already used"};
+    auto state = std::move(_state);
+    state->_value.emplace(std::move(value));
+    complete(*state, State::READY);
+  }
+
+ private:
+  void close() {
+    if (auto state = std::move(_state)) {
+      complete(*state, State::CLOSED);
+    }
+  }
+
+  // 发布结果：接收方已挂起时唤醒它，同时唤醒阻塞在 get 上的线程
+  static void complete(State& state, std::uint8_t result) {
+    auto prev = state._state.exchange(result, std::memory_order::acq_rel);
+    if (prev == State::WAITING) {
+      state._parked.wake();
+    }
+    state._state.notify_all();
+  }
+
+ private:
+  std::shared_ptr<State> _state;  // 共享状态，发送后为空
+};
+
+// 一次性通道的接收方：在协程中 co_await recv()，或在普通线程中阻塞 get()
+// 值只能取出一次，发送方没有发送就销毁时得到空值
+template <typename T>
+class OneshotReceiver {
+  using State = OneshotState<T>;
+
+ public:
+  class Awaiter {
+   public:
+    explicit Awaiter(State& state) : _state(&state) {}
+
+    bool await_ready() const noexcept { return completed(*_state); }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      _state->_parked = Parked{handle};
+      auto expected = std::uint8_t{State::EMPTY};
+      if (_state->_state.compare_exchange_strong(expected, State::WAITING,
+                                                 std::memory_order::acq_rel)) {
+        return true;
+      }
+      // 挂起前已经有结果，不挂起
+      _state->_parked.cancel();
+      return false;
+    }
+    std::optional<T> await_resume() { return take(*_state); }
+
+   private:
+    State* _state;
+  };
+
+ public:
+  explicit OneshotReceiver(std::shared_ptr<State> state)
+      : _state(std::move(state)) {}
+
+ public:
+  // 在协程中等待值
+  [[nodiscard]]
+  Awaiter recv() {
+    return Awaiter{*_state};
+  }
+
+  // 不等待：已经发送时取出值，否则返回空
+  std::optional<T> try_recv() {
+    if (!completed(*_state)) return std::nullopt;
+    return take(*_state);
+  }
+
+  // 阻塞当前线程直到发送或发送方销毁，不要在 worker 上调用
+  std::optional<T> get() {
+    auto state = _state->_state.load(std::memory_order::acquire);
+    while (state == State::EMPTY) {
+      _state->_state.wait(state, std::memory_order::acquire);
+      state = _state->_state.load(std::memory_order::acquire);
+    }
+    return take(*_state);
+  }
+
+  // 是否已经发送(或发送方已销毁)
+  [[nodiscard]]
+  bool ready() const {
+    return completed(*_state);
+  }
+
+ private:
+  static bool completed(const State& state) {
+    auto value = state._state.load(std::memory_order::acquire);
+    return value == State::READY || value == State::CLOSED;
+  }
+
+  static std::optional<T> take(State& state) {
+    return std::exchange(state._value, std::nullopt);
+  }
+
+ private:
+  std::shared_ptr<State> _state;  // 共享状态
+};
+
+// 创建一次性通道，返回发送方和接收方
+template <typename T>
+std::pair<OneshotSender<T>, OneshotReceiver<T>> make_oneshot() {
+  auto state = std::make_shared<OneshotState<T>>();
+  return {OneshotSender<T>{state}, OneshotReceiver<T>{state}};
+}
+
+// 广播通道：每个值发送给所有订阅者
+// 所有订阅者共享一个容量为 capacity 的环形缓冲区，各自维护读取游标；
+// 发送方从不等待，订阅者落后超过 capacity 个值时跳过被覆盖的值并记入 lagged
+// 订阅者没有新值时挂起协程，发送时唤醒所有挂起的订阅者
+// 值以拷贝的方式交给每个订阅者，T 需要可拷贝
+template <typename T>
+class Broadcast : util::noncopyable {
+ public:
+  class Receiver;
+
+ public:
+  explicit Broadcast(std::size_t capacity)
+      : _slots(std::max<std::size_t>(1, capacity)) {}
+
+ public:
+  // 发送值给所有订阅者，通道已关闭时抛出异常
+  void send(T value) {
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      if (_closed) throw std::runtime_error{"channel is closed"};
+      _slots[_tail % _slots.size()] = std::move(value);
+      ++_tail;
+      ready.swap(_waiters);
+    }
+    wake_all(ready);
+  }
+
+  // 关闭通道：订阅者读完剩余的值后得到空值
+  void close() {
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      _closed = true;
+      ready.swap(_waiters);
+    }
+    wake_all(ready);
+  }
+
+  // 创建订阅者，只接收订阅之后发送的值
+  Receiver subscribe() {
+    std::lock_guard lock{_mutex};
+    return Receiver{*this, _tail};
+  }
+
+  [[nodiscard]]
+  std::size_t capacity() const {
+    return _slots.size();
+  }
+
+ private:
+  // 按游标读取下一个值，落后太多时先跳到最早的值(调用方持有锁)
+  // 返回是否有结果：读到值，或通道已关闭且没有剩余的值
+  bool poll_locked(std::uint64_t& cursor, std::uint64_t& lagged,
+                   std::optional<T>& out) {
+    if (cursor < _tail) {
+      auto oldest = _tail > _slots.size() ? _tail - _slots.size() : 0;
+      if (cursor < oldest) {
+        lagged += oldest - cursor;
+        cursor = oldest;
+      }
+      out = _slots[cursor % _slots.size()];
+      ++cursor;
+      return true;
+    }
+    return _closed;
+  }
+
+  static void wake_all(std::vector<Parked*>& ready) {
+    for (auto parked : ready) {
+      parked->wake();
+    }
+  }
+
+ private:
+  std::mutex _mutex{};                   // 保护以下所有状态
+  std::vector<std::optional<T>> _slots;  // 共享的环形缓冲区
+  std::uint64_t _tail{0};                // 下一个值的序号
+  std::vector<Parked*> _waiters{};       // 挂起的订阅者
+  bool _closed{false};                   // 是否关闭
+};
+
+// 广播通道的订阅者
+template <typename T>
+class Broadcast<T>::Receiver {
+  friend class Broadcast<T>;
+
+ public:
+  class Awaiter {
+   public:
+    explicit Awaiter(Receiver& receiver) : _receiver(&receiver) {}
+
+    bool await_ready() {
+      return _receiver->poll(_value) && !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      auto& channel = *_receiver->_channel;
+      std::lock_guard lock{channel._mutex};
+      if (channel.poll_locked(_receiver->_cursor, _receiver->_lagged,
+                              _value)) {
+        return false;
+      }
+      _parked = Parked{handle};
+      channel._waiters.push_back(&_parked);
+      return true;
+    }
+    std::optional<T> await_resume() {
+      if (!_value) _receiver->poll(_value);
+      return std::move(_value);
+    }
+
+   private:
+    Receiver* _receiver;
+    std::optional<T> _value{};
+    Parked _parked{};
+    bool _yield{false};  // 已经完成但预算耗尽，挂起让出 worker
+  };
+
+ public:
+  // 在协程中接收下一个值，没有新值时挂起，通道关闭且读完后返回空
+  [[nodiscard]]
+  Awaiter recv() {
+    return Awaiter{*this};
+  }
+
+  // 不挂起地接收下一个值，没有新值时返回空
+  std::optional<T> try_recv() {
+    std::optional<T> value;
+    poll(value);
+    return value;
+  }
+
+  // 因为落后而跳过的值的数量
+  [[nodiscard]]
+  std::uint64_t lagged() const {
+    return _lagged;
+  }
+
+ private:
+  Receiver(Broadcast& channel, std::uint64_t cursor)
+      : _channel(&channel), _cursor(cursor) {}
+
+  bool poll(std::optional<T>& out) {
+    std::lock_guard lock{_channel->_mutex};
+    return _channel->poll_locked(_cursor, _lagged, out);
+  }
+
+ private:
+  Broadcast* _channel;      // 所属的广播通道
+  std::uint64_t _cursor;    // 下一个要读取的值的序号
+  std::uint64_t _lagged{0};  // 跳过的值的数量
+};
+
+// 观察通道：只保存最新的值和版本号，适合配置下发、状态和关闭信号
+// 每次 send 版本号加一并唤醒所有等待变化的接收方，接收方只关心最新值，
+// 中间的值可能被跳过；读取版本号不加锁
+template <typename T>
+class Watch : util::noncopyable {
+ public:
+  class Receiver;
+
+ public:
+  explicit Watch(T initial) : _value(std::move(initial)) {}
+
+ public:
+  // 更新值并唤醒等待变化的接收方，通道已关闭时抛出异常
+  void send(T value) {
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      if (_closed) throw std::runtime_error{"channel is closed"};
+      _value = std::move(value);
+      _version.fetch_add(1, std::memory_order::release);
+      ready.swap(_waiters);
+    }
+    wake_all(ready);
+  }
+
+  // 关闭通道：等待变化的接收方得到 false
+  void close() {
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      _closed = true;
+      ready.swap(_waiters);
+    }
+    wake_all(ready);
+  }
+
+  // 当前值的拷贝
+  [[nodiscard]]
+  T get() const {
+    std::lock_guard lock{_mutex};
+    return _value;
+  }
+
+  // 当前版本号，初始值的版本号为 0
+  [[nodiscard]]
+  std::uint64_t version() const {
+    return _version.load(std::memory_order::acquire);
+  }
+
+  // 创建接收方，当前值视为已经看到
+  Receiver subscribe() { return Receiver{*this, version()}; }
+
+ private:
+  static void wake_all(std::vector<Parked*>& ready) {
+    for (auto parked : ready) {
+      parked->wake();
+    }
+  }
+
+ private:
+  mutable std::mutex _mutex{};               // 保护值和等待列表
+  T _value;                                  // 最新的值
+  std::atomic<std::uint64_t> _version{0};    // 版本号
+  std::vector<Parked*> _waiters{};           // 等待变化的接收方
+  bool _closed{false};                       // 是否关闭
+};
+
+// 观察通道的接收方，记录已经看到的版本号
+template <typename T>
+class Watch<T>::Receiver {
+  friend class Watch<T>;
+
+ public:
+  class Awaiter {
+   public:
+    explicit Awaiter(Receiver& receiver) : _receiver(&receiver) {}
+
+    bool await_ready() const noexcept { return _receiver->has_changed(); }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      auto& channel = *_receiver->_channel;
+      std::lock_guard lock{channel._mutex};
+      if (_receiver->has_changed() || channel._closed) return false;
+      _parked = Parked{handle};
+      channel._waiters.push_back(&_parked);
+      return true;
+    }
+    // 有新版本时返回 true 并标记为已看到，通道关闭时返回 false
+    bool await_resume() {
+      auto version = _receiver->_channel->version();
+      if (version == _receiver->_seen) return false;
+      _receiver->_seen = version;
+      return true;
+    }
+
+   private:
+    Receiver* _receiver;
+    Parked _parked{};
+  };
+
+ public:
+  // 在协程中等待值变化：co_await receiver.changed()
+  [[nodiscard]]
+  Awaiter changed() {
+    return Awaiter{*this};
+  }
+
+  // 是否有还没看到的新版本
+  [[nodiscard]]
+  bool has_changed() const {
+    return _channel->version() != _seen;
+  }
+
+  // 读取最新值，并标记为已看到
+  T get() {
+    std::lock_guard lock{_channel->_mutex};
+    _seen = _channel->_version.load(std::memory_order::relaxed);
+    return _channel->_value;
+  }
+
+ private:
+  Receiver(Watch& channel, std::uint64_t seen)
+      : _channel(&channel), _seen(seen) {}
+
+ private:
+  Watch* _channel;     // 所属的观察通道
+  std::uint64_t _seen;  // 已经看到的版本号
+};
+}  // namespace fastexec::detail
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef __FASTSTDEXEC_DETAIL_CORO_HPP
+#define __FASTSTDEXEC_DETAIL_CORO_HPP
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "taskgroup.hpp"
+namespace fastexec::detail {
+// 把挂起的协程包装成恢复任务，交给 worker 执行
+// 挂起时捕获当前任务组并计数 +1，恢复执行时重新设置任务组上下文，
+// 这样挂起等待中的协程同样会让 block_on 等待它
+inline std::function<void()> make_resume_job(std::coroutine_handle<> handle) {
+  auto group = t_current_task_group;
+  if (group) {
+    group->increment();
+  }
+  return [handle, group]() {
+    // 恢复任务不能被丢弃，照常恢复执行
+    t_discard_task = false;
+    ContextGuard guard(group);
+    handle.resume();
+  };
+}
+
+// Task<T> 的 promise 中与返回值类型相关的部分
+template <typename T>
+struct TaskResult {
+  std::optional<T> _value{};
+  std::exception_ptr _exception{};
+
+  void return_value(T value) { _value.emplace(std::move(value)); }
+  void unhandled_exception() { _exception = std::current_exception(); }
+
+  T result() {
+    if (_exception) std::rethrow_exception(_exception);
+    return std::move(*_value);
+  }
+};
+
+template <>
+struct TaskResult<void> {
+  std::exception_ptr _exception{};
+
+  void return_void() {}
+  void unhandled_exception() { _exception = std::current_exception(); }
+
+  void result() {
+    if (_exception) std::rethrow_exception(_exception);
+  }
+};
+
+// 协程任务：惰性启动，被 co_await 时才开始执行，执行完后恢复等待它的协程
+// 通过 co_spawn 交给线程池执行，在协程内可以 co_await 库提供的可等待对象
+template <typename T = void>
+class Task {
+ public:
+  struct promise_type : TaskResult<T> {
+    std::coroutine_handle<> _continuation{std::noop_coroutine()};
+
+    Task get_return_object() {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // 结束时直接转移到等待它的协程(对称转移)，不增加栈深度
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+        return handle.promise()._continuation;
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+  };
+
+ public:
+  Task(Task&& other) noexcept
+      : _handle(std::exchange(other._handle, nullptr)) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (_handle) _handle.destroy();
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+  ~Task() {
+    if (_handle) _handle.destroy();
+  }
+
+ public:
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
+    _handle.promise()._continuation = continuation;
+    return _handle;
+  }
+  T await_resume() { return _handle.promise().result(); }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+ private:
+  std::coroutine_handle<promise_type> _handle{};
+};
+
+// 分离执行的协程：立即开始执行，结束时自动销毁
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// 执行 Task，把结果或异常写入 promise
+template <typename T>
+DetachedTask run_detached(Task<T> task, std::promise<T> promise) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      promise.set_value();
+    } else {
+      promise.set_value(co_await std::move(task));
+    }
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+  }
+}
+}  // namespace fastexec::detail
+
+#endif
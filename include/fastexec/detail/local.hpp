@@ -0,0 +1,131 @@
+#ifndef __FASTSTDEXEC_DETAIL_LOCAL_HPP
+#define __FASTSTDEXEC_DETAIL_LOCAL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "shared.hpp"
+#include "util.hpp"
+namespace fastexec::detail {
+// worker 局部存储：线程池的每个 worker 槽位一个 T，按 worker id 直接索引，
+// 每个元素独占缓存行，worker 之间累加计数、填充缓冲区不需要加锁也没有伪共享
+// 元素在所属线程第一次访问时用 init 构造，只由该线程访问；
+// 不是该线程池 worker 的线程(外部线程、阻塞任务线程)各自在加锁的
+// 溢出表中有一个元素
+// for_each / combine 遍历所有构造过的元素，需要在并行阶段结束之后调用
+// (例如 block_on 返回或 future 就绪之后)
+template <typename T>
+class WorkerLocal : util::noncopyable {
+ public:
+  // scheduler 为所属线程池，slots 为它的 worker 槽位数
+  WorkerLocal(const Scheduler* scheduler, std::size_t slots,
+              std::function<T()> init)
+      : _scheduler(scheduler),
+        _slot_num(slots),
+        _slots(std::make_unique<Slot[]>(slots)),
+        _init(std::move(init)) {}
+
+ public:
+  // 当前线程的元素，第一次访问时构造
+  T& local() {
+    if (t_scheduler == _scheduler) {
+      auto& value = _slots[t_worker_id]._value;
+      if (!value.has_value()) {
+        value.emplace(_init());
+      }
+      return *value;
+    }
+    return external_local();
+  }
+
+  // 对每个构造过的元素调用 f(T&)，worker 的元素按 worker id 顺序在前
+  template <typename F>
+  void for_each(F&& f) {
+    for (std::size_t i = 0; i < _slot_num; ++i) {
+      if (_slots[i]._value.has_value()) {
+        f(*_slots[i]._value);
+      }
+    }
+    std::lock_guard lock{_mutex};
+    for (auto& [id, slot] : _external) {
+      f(*slot._value);
+    }
+  }
+
+  // 用 op(T, T) 依次合并所有构造过的元素，没有元素时返回 init 构造的值
+  template <typename Op>
+  T combine(Op op) {
+    std::optional<T> result;
+    for_each([&](T& value) {
+      if (result.has_value()) {
+        result.emplace(op(std::move(*result), value));
+      } else {
+        result.emplace(value);
+      }
+    });
+    return result.has_value() ? std::move(*result) : _init();
+  }
+
+  // 构造过的元素数量
+  [[nodiscard]]
+  std::size_t size() {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < _slot_num; ++i) {
+      n += _slots[i]._value.has_value() ? 1 : 0;
+    }
+    std::lock_guard lock{_mutex};
+    return n + _external.size();
+  }
+
+  // 销毁所有元素，之后再访问时重新构造，不能与 local 同时调用
+  void clear() {
+    for (std::size_t i = 0; i < _slot_num; ++i) {
+      _slots[i]._value.reset();
+    }
+    std::lock_guard lock{_mutex};
+    _external.clear();
+  }
+
+ private:
+  // 独占缓存行的元素
+  struct alignas(64) Slot {
+    std::optional<T> _value{};
+  };
+
+  // 不是 worker 的线程按线程 id 在溢出表中查找自己的元素，没有时构造
+  // deque 追加元素不会移动已有元素，返回的引用一直有效
+  T& external_local() {
+    auto id = std::this_thread::get_id();
+    std::lock_guard lock{_mutex};
+    for (auto& [owner, slot] : _external) {
+      if (owner == id) {
+        return *slot._value;
+      }
+    }
+    auto& slot = _external
+                     .emplace_back(std::piecewise_construct,
+                                   std::forward_as_tuple(id),
+                                   std::forward_as_tuple())
+                     .second;
+    slot._value.emplace(_init());
+    return *slot._value;
+  }
+
+ private:
+  const Scheduler* _scheduler;            // 所属线程池
+  std::size_t _slot_num;                  // worker 槽位数
+  std::unique_ptr<Slot[]> _slots;         // 各 worker 槽位的元素
+  std::function<T()> _init;               // 构造元素的初始值
+  std::mutex _mutex{};                    // 保护溢出表
+  std::deque<std::pair<std::thread::id, Slot>> _external{};  // 其他线程的元素
+};
+}  // namespace fastexec::detail
+
+#endif
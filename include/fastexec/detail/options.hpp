@@ -0,0 +1,73 @@
+#ifndef __FASTSTDEXEC_DETAIL_OPTIONS_HPP
+#define __FASTSTDEXEC_DETAIL_OPTIONS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "affinity.hpp"
+namespace fastexec::detail {
+// worker 空闲策略：取不到任务时先让出 CPU 重试 spin_rounds 轮，再进入休眠，
+// 每次休眠最多 park_timeout，期间可以被新提交的任务提前唤醒
+struct IdlePolicy {
+  std::size_t spin_rounds{0};                   // 休眠前的重试轮数
+  std::chrono::microseconds park_timeout{100};  // 单次休眠的最长时间
+};
+
+// worker 数量动态伸缩：活跃 worker 数在 [min_active, thread_num] 之间变化
+// 活跃 worker 连续空闲 idle_timeout 后停用，停用的 worker 不再定时醒来，
+// 一直休眠到被启用(把 CPU 还给其他进程)；排队任务数持续超过
+// 活跃 worker 数 * backlog_per_worker 时启用一个停用的 worker
+struct ScalingPolicy {
+  std::size_t min_active{0};  // 最少活跃 worker 数，0 表示不伸缩
+  std::size_t backlog_per_worker{16};  // 每个活跃 worker 可以积压的任务数
+  std::chrono::milliseconds idle_timeout{100};  // 停用前的连续空闲时间
+};
+
+// 全局队列已满时新任务的处理策略
+enum class OverflowPolicy {
+  block,        // 阻塞提交线程直到有空间(worker 线程上退化为 caller_runs)
+  reject,       // 拒绝：提交时抛出异常
+  caller_runs,  // 在提交线程上直接执行
+  drop_oldest,  // 丢弃队列中最早的任务，其 future 得到异常
+};
+
+// 关闭线程池时如何处理排队中的任务，正在执行的任务都会执行完
+enum class ShutdownMode {
+  drain,  // 执行完所有已经排队的任务后退出
+  abort,  // 丢弃还没有开始执行的任务，其 future 得到异常
+};
+
+// 各溢出策略生效的次数
+struct OverflowStats {
+  std::uint64_t blocked{0};      // 提交线程等待空间的次数
+  std::uint64_t rejected{0};     // 拒绝的任务数
+  std::uint64_t caller_runs{0};  // 在提交线程上执行的任务数
+  std::uint64_t dropped{0};      // 丢弃的任务数
+};
+
+// 线程池配置
+struct PoolOptions {
+  // 线程数，默认为亲和性掩码中的 CPU 数，并受 cgroup CPU 配额限制
+  std::size_t thread_num{Topology::available_parallelism()};
+  // resize 可以调整到的最大线程数，0 表示线程数和硬件并发度中较大的那个
+  std::size_t max_thread_num{0};
+  std::size_t queue_capacity{256};  // 本地队列容量，向上取整到 2 的幂
+  std::size_t max_queue_capacity{0};  // 本地队列扩容上限，0 表示不扩容
+  IdlePolicy idle{};                // 空闲策略
+  ScalingPolicy scaling{};          // worker 数量动态伸缩策略
+  AffinityPolicy affinity{AffinityPolicy::none};  // CPU 亲和性策略
+  std::vector<int> cpu_list{};  // list 策略下 worker i 绑定 cpu_list[i % size]
+  std::string thread_name{"fastexec"};  // 线程名前缀，线程名为 "<前缀>-w<id>"
+  std::size_t max_blocking_threads{512};  // 阻塞任务线程数上限
+  std::chrono::milliseconds blocking_keep_alive{
+      std::chrono::seconds(10)};  // 阻塞任务线程的空闲存活时间
+  std::size_t global_queue_capacity{0};  // 每个全局队列的容量，0 表示不限制
+  OverflowPolicy overflow_policy{OverflowPolicy::block};  // 全局队列满时的策略
+};
+}  // namespace fastexec::detail
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef __FASTSTDEXEC_DETAIL_POLICY_HPP
+#define __FASTSTDEXEC_DETAIL_POLICY_HPP
+
+#include <concepts>
+#include <cstddef>
+namespace fastexec::detail {
+// 本地队列容量取该值时，容量在构造时(运行时)指定，存储改为堆上分配的数组
+inline constexpr std::size_t dynamic_capacity = 0;
+
+// 调度策略：编译期确定的调度参数，线程池以它为模板参数
+// 队列的下标掩码、窃取数量、批量大小都变成常量，热路径在编译期特化，
+// 不同调优的线程池可以在同一个程序里共存
+//   local_queue_capacity   本地队列容量(2 的幂)，dynamic_capacity 表示使用
+//                          PoolOptions::queue_capacity(并且允许扩容)
+//   steal_divisor          每次窃取目标队列任务数的 1/steal_divisor
+//   global_batch_divisor   从全局队列批量取任务时，最多取本地队列容量的
+//                          1/global_batch_divisor
+//   steal_throttle_divisor 同时窃取的 worker 数不超过总数的
+//                          1/steal_throttle_divisor
+//   global_queue_interval  每取 global_queue_interval 个任务先检查一次全局队列，
+//                          本地任务不断派生时外部提交的任务也不会被饿死
+struct DefaultPolicy {
+  constexpr static std::size_t local_queue_capacity = dynamic_capacity;
+  constexpr static std::size_t steal_divisor = 2;
+  constexpr static std::size_t global_batch_divisor = 2;
+  constexpr static std::size_t steal_throttle_divisor = 2;
+  constexpr static std::size_t global_queue_interval = 61;
+};
+
+// 吞吐优先：大容量的固定本地队列，每次从全局队列取更多任务，窃取更积极
+struct ThroughputPolicy : DefaultPolicy {
+  constexpr static std::size_t local_queue_capacity = 1024;
+  constexpr static std::size_t global_batch_divisor = 1;
+  constexpr static std::size_t steal_throttle_divisor = 1;
+};
+
+// 延迟优先：小容量的固定本地队列，任务很快溢出给其他 worker，
+// 每次只从全局队列取少量任务，窃取时只拿走四分之一，
+// 更频繁地检查全局队列，新请求的排队时间更短
+struct LatencyPolicy : DefaultPolicy {
+  constexpr static std::size_t local_queue_capacity = 64;
+  constexpr static std::size_t steal_divisor = 4;
+  constexpr static std::size_t global_batch_divisor = 8;
+  constexpr static std::size_t global_queue_interval = 17;
+};
+
+// 调度策略需要满足的约束
+template <typename P>
+concept SchedulerPolicy = requires {
+  { P::local_queue_capacity } -> std::convertible_to<std::size_t>;
+  { P::steal_divisor } -> std::convertible_to<std::size_t>;
+  { P::global_batch_divisor } -> std::convertible_to<std::size_t>;
+  { P::steal_throttle_divisor } -> std::convertible_to<std::size_t>;
+  { P::global_queue_interval } -> std::convertible_to<std::size_t>;
+} && (P::local_queue_capacity & (P::local_queue_capacity - 1)) == 0 &&
+                          P::steal_divisor >= 2 &&
+                          P::global_batch_divisor >= 1 &&
+                          P::steal_throttle_divisor >= 1 &&
+                          P::global_queue_interval >= 1;
+}  // namespace fastexec::detail
+
+#endif
@@ -1,50 +1,535 @@
 #ifndef __FASTSTDEXEC_DETAIL_POOL_HPP
 #define __FASTSTDEXEC_DETAIL_POOL_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
 #include <cstddef>
+#include <exception>
 #include <functional>
 #include <future>
-#include <latch>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <ranges>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
+#include "blocking.hpp"
+#include "coro.hpp"
+#include "options.hpp"
+#include "policy.hpp"
 #include "taskgroup.hpp"
+#include "uring.hpp"
 #include "worker.hpp"
 namespace fastexec::detail {
-// 线程局部存储，当前任务所属的任务组指针
-static inline thread_local std::shared_ptr<TaskGroup> t_current_task_group{
-    nullptr};
-// 线程池类，管理工作线程和任务分发
-class thread_pool : public util::Singleton<thread_pool> {
-  friend class util::Singleton<thread_pool>;
+// 批量任务的任务帧：同一批任务共享一个函数对象，参数和 promise 连续存放
+// 各任务在不同 worker 上同时调用这个函数对象，所以只通过 const 引用调用
+template <typename F, typename Arg, typename R>
+struct BatchFrames {
+  F _func;
+  std::shared_ptr<TaskGroup> _group;
+  std::vector<Arg> _args{};
+  std::vector<std::promise<R>> _promises{};
 
- public:
-  // 析构函数，停止线程池并等待所有线程完成
-  ~thread_pool() {
-    if (!_shared.get_global_queue().closed()) {
-      close();
+  BatchFrames(F func, std::shared_ptr<TaskGroup> group)
+      : _func(std::move(func)), _group(std::move(group)) {}
+
+  // 执行第 i 个任务，结果写入对应的 promise
+  void run(std::size_t i) {
+    ContextGuard guard(_group);
+    if (std::exchange(t_discard_task, false)) {
+      _promises[i].set_exception(
+          std::make_exception_ptr(std::runtime_error{"task dropped"}));
+      return;
     }
-    for (auto& thread : _threads) {
-      if (thread.joinable()) {
-        thread.join();
+    try {
+      if constexpr (std::is_void_v<R>) {
+        std::as_const(_func)(_args[i]);
+        _promises[i].set_value();
+      } else {
+        _promises[i].set_value(std::as_const(_func)(_args[i]));
       }
+    } catch (...) {
+      _promises[i].set_exception(std::current_exception());
     }
   }
+};
+
+// 线程池类，管理工作线程和任务分发
+// 可以按 PoolOptions 创建多个相互独立的实例，默认实例见 exec.hpp
+// 编译期的调度参数(队列容量、窃取比例、批量大小等)由调度策略 Policy 给出
+template <SchedulerPolicy Policy = DefaultPolicy>
+class basic_thread_pool : util::noncopyable {
+ public:
+  // 构造函数，创建线程池并初始化工作者
+  explicit basic_thread_pool(PoolOptions options = {})
+      : _options(std::move(options)) {
+    // 启动工作线程
+    _shared.set_worker_limit(_thread_num);
+    start_workers(std::views::iota(std::size_t{0}, _thread_num.load()));
+  }
+
 
-  void close() { _shared.global_queue_close(); }
+  // 析构函数，停止线程池并等待所有线程完成
+  // 阻塞任务线程中可能还有文件 I/O 的退化操作引用 _file_io，也等它们结束
+  ~basic_thread_pool() { shutdown(); }
 
-  // 等待所有任务完成
+  // 关闭线程池，不再接受新任务，worker 执行完排队的任务后退出
+  void close() {
+    _shared.global_queue_close();
+    _blocking.close();
+  }
+
+  // 等待所有任务完成(需要先 close)
   void wait_for_all() {
-    // 等待所有 Worker 线程完成任务
-    for (auto& worker : _threads) {
-      worker.join();
+    std::lock_guard lock{_control_mutex};
+    join_workers();
+  }
+
+  // 关闭线程池并等待所有线程退出，之后可以用 restart 重新启动
+  // drain 执行完所有排队中的任务；abort 丢弃还没有开始执行的任务，
+  // 它们的 future 得到异常；正在执行的任务都会执行完
+  // 未到期的定时器被丢弃；已经关闭时只等待线程退出
+  void shutdown(ShutdownMode mode = ShutdownMode::drain) {
+    check_not_worker();
+    std::lock_guard lock{_control_mutex};
+    if (mode == ShutdownMode::abort) {
+      abort();
+    } else if (!_shared.global_queue_closed()) {
+      close();
     }
+    join_workers();
+  }
+
+  // 关闭线程池，最多等待 timeout 执行排队中的任务，
+  // 超时后丢弃剩余的任务(同 abort)，再等待正在执行的任务结束
+  // 返回排队中的任务是否都在 timeout 内执行完
+  bool shutdown(std::chrono::milliseconds timeout) {
+    check_not_worker();
+    std::lock_guard lock{_control_mutex};
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    if (!_shared.global_queue_closed()) {
+      close();
+    }
+    bool drained = false;
+    {
+      std::unique_lock exit_lock{_exit_mutex};
+      drained = _exit_cv.wait_until(exit_lock, deadline,
+                                    [this] { return _running_threads == 0; });
+    }
+    drained = drained && _blocking.join_until(deadline);
+    if (!drained) {
+      abort();
+    }
+    join_workers();
+    return drained;
+  }
+
+  // 重新启动已经关闭的线程池：重新打开全局队列和阻塞任务线程池，
+  // 按当前的线程数启动 worker；线程池还在运行时抛出异常
+  void restart() {
+    check_not_worker();
+    std::lock_guard lock{_control_mutex};
+    if (!_shared.global_queue_closed()) {
+      throw std::runtime_error{"pool is running"};
+    }
+    join_workers();
+    _shared.global_queue_reopen();
+    _blocking.reopen();
+    auto n = thread_num();
+    _shared.set_worker_limit(n);
+    start_workers(std::views::iota(std::size_t{0}, n));
   }
 
  public:
   // 提交任务到线程池
   template <typename F, typename... Args>
   std::future<std::invoke_result_t<F, Args...>> submit(F&& f, Args&&... args) {
+    return submit(Priority::normal, std::forward<F>(f),
+                  std::forward<Args>(args)...);
+  }
+
+  // 以指定优先级提交任务到线程池
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> submit(Priority priority,
+                                                       F&& f, Args&&... args) {
+    auto [job, fut] = make_job(std::forward<F>(f), std::forward<Args>(args)...);
+
+    // 检查当前线程是否是本线程池的 Worker 线程
+    if (auto worker = local_worker()) {
+      // 如果是 Worker 线程，直接加入到自己对应优先级的本地队列
+      if (worker->can_push_back_task_to_local(priority)) {
+        worker->push_back_task_to_local(std::move(job), priority);
+      } else {
+        // 本地队列和全局队列都满了，按溢出策略处理(worker 线程不阻塞)
+        _shared.handle_overflow(
+            _shared.get_global_queue(worker->get_numa_node(),
+                                     level_of(priority)),
+            std::span{&job, 1}, false);
+      }
+    } else {
+      // 外部线程(或其他线程池的 Worker 线程)，有休眠的 worker 时直接交给它，
+      // 否则加入到对应优先级的全局队列
+      // 队列已满时按溢出策略处理，只有非 worker 线程会阻塞等待
+      if (!_shared.try_handoff(job, priority)) {
+        _shared.admit_task_to_global(std::move(job), priority,
+                                     t_scheduler == nullptr);
+        // 活跃 worker 处理不过来时启用一个停用的 worker
+        if (_shared.is_backlogged()) {
+          _shared.activate_worker();
+        }
+      }
+    }
+    return std::move(fut);
+  }
+
+  // 提交任务到指定 worker 的收件箱，任务只会在该 worker 上执行，不会被窃取
+  // 同一个 worker 上的任务串行执行，只由它访问的数据不需要加锁
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> submit_on(std::size_t worker_id,
+                                                          F&& f,
+                                                          Args&&... args) {
+    if (worker_id >= thread_num()) {
+      throw std::out_of_range{"worker id out of range"};
+    }
+    if (_shared.global_queue_closed()) {
+      throw std::runtime_error{"queue is closed"};
+    }
+    auto [job, fut] = make_job(std::forward<F>(f), std::forward<Args>(args)...);
+    _shared.push_back_task_to_inbox(worker_id, std::move(job));
+    return std::move(fut);
+  }
+
+  // 提交带截止时间(绝对时间)的任务，worker 优先执行截止时间最早的任务
+  // 任务完成时已经超过截止时间，计入 missed_deadlines
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> submit_with_deadline(
+      deadline_clock::time_point deadline, F&& f, Args&&... args) {
+    auto [job, fut] = make_job(std::forward<F>(f), std::forward<Args>(args)...);
+    auto deadline_job = [this, deadline, job = std::move(job)]() {
+      job();
+      if (deadline_clock::now() > deadline) {
+        _shared.record_missed_deadline();
+      }
+    };
+
+    if (auto worker = local_worker()) {
+      // Worker 线程：加入自己的截止时间队列
+      worker->push_deadline_task_to_local(deadline, std::move(deadline_job));
+    } else {
+      // 外部线程：加入全局截止时间队列，并唤醒一个空闲 worker 尽快执行
+      _shared.push_deadline_task_to_global(deadline, std::move(deadline_job));
+      _shared.notify_workers(1);
+    }
+    return std::move(fut);
+  }
+
+  // 在 when 时刻执行 f(args...)，返回可以取消定时器的句柄
+  // 定时器不加入当前任务组，block_on 不会等待未到期的定时器，
+  // 线程池关闭时未到期的定时器被丢弃
+  template <typename F, typename... Args>
+  TimerHandle submit_at(deadline_clock::time_point when, F&& f,
+                        Args&&... args) {
+    return insert_timer(when, deadline_clock::duration::zero(),
+                        std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 在 delay 之后执行 f(args...)
+  template <typename F, typename... Args>
+  TimerHandle submit_after(deadline_clock::duration delay, F&& f,
+                           Args&&... args) {
+    return submit_at(deadline_clock::now() + delay, std::forward<F>(f),
+                     std::forward<Args>(args)...);
+  }
+
+  // 每隔 period 执行一次 f(args...)，直到取消或线程池关闭
+  template <typename F, typename... Args>
+  TimerHandle submit_every(deadline_clock::duration period, F&& f,
+                           Args&&... args) {
+    return insert_timer(deadline_clock::now() + period, period,
+                        std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 在线程池中执行协程任务，返回获取协程结果的 future
+  // 协程挂起等待期间不占用 worker，恢复时在 worker 上继续执行，
+  // 挂起中的协程同样属于当前任务组，block_on 会等待它完成
+  template <typename T>
+  std::future<T> co_spawn(Task<T> task) {
+    std::promise<T> promise;
+    auto fut = promise.get_future();
+    submit([task = std::move(task), promise = std::move(promise)]() mutable {
+      run_detached(std::move(task), std::move(promise));
+    });
+    return fut;
+  }
+
+  // fd 就绪时执行 f(args...)(一次性)，返回future，同样会关联当前任务组
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> submit_on_ready(
+      int fd, Readiness readiness, F&& f, Args&&... args) {
+    auto [job, fut] = make_job(std::forward<F>(f), std::forward<Args>(args)...);
+    try {
+      _shared.reactor().add_waiter(fd, readiness, std::move(job));
+    } catch (...) {
+      // 等待没有注册成功，撤销 make_job 对任务组的计数
+      if (t_current_task_group) t_current_task_group->decrement();
+      throw;
+    }
+    return std::move(fut);
+  }
+
+  // 在协程中 co_await 等待 fd 就绪
+  ReadinessAwaiter wait_ready(int fd, Readiness readiness) {
+    return ReadinessAwaiter{_shared.reactor(), fd, readiness};
+  }
+
+  // 停止监听 fd，并唤醒 fd 上所有等待者(回调照常执行)，关闭 fd 之前调用
+  void release_fd(int fd) {
+    std::vector<std::function<void()>> ready;
+    _shared.reactor().release(fd, ready);
+    for (auto& job : ready) {
+      schedule(std::move(job));
+    }
+  }
+
+  // co_await 从 fd 的 offset 处读取到 buf，返回读取的字节数，失败时为 -errno
+  FileOpAwaiter read_at(int fd, std::span<std::byte> buf,
+                        std::uint64_t offset) {
+    return FileOpAwaiter{_file_io, make_file_op(FileOp::Kind::read, fd,
+                                                buf.data(), buf.size(), offset),
+                         local_worker() != nullptr};
+  }
+
+  // co_await 把 buf 写入 fd 的 offset 处，返回写入的字节数，失败时为 -errno
+  FileOpAwaiter write_at(int fd, std::span<const std::byte> buf,
+                         std::uint64_t offset) {
+    return FileOpAwaiter{
+        _file_io,
+        make_file_op(FileOp::Kind::write, fd, const_cast<std::byte*>(buf.data()),
+                     buf.size(), offset),
+        local_worker() != nullptr};
+  }
+
+  // 读取完成后执行 f(读取的字节数或 -errno)，返回future，同样会关联当前任务组
+  template <typename F>
+  std::future<std::invoke_result_t<F, std::int64_t>> read_at(
+      int fd, std::span<std::byte> buf, std::uint64_t offset, F&& f) {
+    return submit_file_op(make_file_op(FileOp::Kind::read, fd, buf.data(),
+                                       buf.size(), offset),
+                          std::forward<F>(f));
+  }
+
+  // 写入完成后执行 f(写入的字节数或 -errno)，返回future
+  template <typename F>
+  std::future<std::invoke_result_t<F, std::int64_t>> write_at(
+      int fd, std::span<const std::byte> buf, std::uint64_t offset, F&& f) {
+    return submit_file_op(
+        make_file_op(FileOp::Kind::write, fd, const_cast<std::byte*>(buf.data()),
+                     buf.size(), offset),
+        std::forward<F>(f));
+  }
+
+  // 分配一个固定缓冲区(优先使用已注册到 io_uring 的缓冲区)
+  FixedBuffer acquire_buffer() { return FixedBuffer{_file_io}; }
+
+  // 提交会阻塞线程的任务到阻塞任务线程池，不占用 worker
+  // 同样会关联当前任务组，block_on 会等待它完成
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> submit_blocking(
+      F&& f, Args&&... args) {
+    auto [job, fut] = make_job(std::forward<F>(f), std::forward<Args>(args)...);
+    try {
+      _blocking.submit(std::move(job));
+    } catch (...) {
+      // 阻塞任务线程池已关闭，撤销 make_job 对任务组的计数
+      if (t_current_task_group) t_current_task_group->decrement();
+      throw;
+    }
+    return std::move(fut);
+  }
+
+  // 批量提交任务：对 range 中每个元素调用一次 f
+  // 任务帧一次性构建，并通过一次队列操作发布，而不是逐个提交
+  // 整批任务共享同一个 f 并发调用，f 必须可以通过 const 引用调用
+  template <std::ranges::input_range R, typename F>
+    requires std::invocable<const std::decay_t<F>&,
+                            std::ranges::range_value_t<R>&>
+  auto submit_batch(R&& range, F&& f) {
+    using arg_type = std::ranges::range_value_t<R>;
+    using return_type =
+        std::invoke_result_t<const std::decay_t<F>&, arg_type&>;
+    using frames_type = BatchFrames<std::decay_t<F>, arg_type, return_type>;
+
+    auto current_group = t_current_task_group;
+    auto frames =
+        std::make_shared<frames_type>(std::forward<F>(f), current_group);
+    if constexpr (std::ranges::sized_range<R>) {
+      frames->_args.reserve(std::ranges::size(range));
+    }
+    for (auto&& arg : range) {
+      frames->_args.emplace_back(std::forward<decltype(arg)>(arg));
+    }
+
+    auto n = frames->_args.size();
+    frames->_promises.resize(n);
+    std::vector<std::future<return_type>> futs;
+    futs.reserve(n);
+    std::vector<std::function<void()>> jobs;
+    jobs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      futs.push_back(frames->_promises[i].get_future());
+      jobs.emplace_back([frames, i]() { frames->run(i); });
+    }
+    if (n == 0) {
+      return futs;
+    }
+
+    // 整批任务一次性加入任务组
+    if (current_group) {
+      current_group->increment(n);
+    }
+    if (auto worker = local_worker()) {
+      // Worker 线程：尽量放入本地队列，放不下的部分一次性放入全局队列
+      worker->push_back_batch_task_to_local(jobs);
+    } else {
+      // 外部线程：一次加锁放入全局队列，放不下的部分按溢出策略处理
+      _shared.admit_batch_task_to_global(jobs, t_scheduler == nullptr);
+    }
+    // 唤醒足够多的空闲 worker 来消费这批任务，活跃 worker 不够时再启用一个
+    _shared.notify_workers(n);
+    if (_shared.is_backlogged()) {
+      _shared.activate_worker();
+    }
+    return futs;
+  }
+
+  // 提交一个任务并阻塞等待，直到它及其所有子任务完成
+  template <typename F, typename... Args>
+  void block_on(F&& f, Args&&... args) {
+    // 1. 创建一个新的任务组记分牌
+    auto group = std::make_shared<TaskGroup>();
+
+    {
+      // 2. 设置当前线程的 TLS 上下文
+      // 这样做的目的是：当我们紧接着调用 submit 时，submit 能够看到这个
+      // group，从而将第一个任务关联到这个 group 中。
+      auto prev_group = t_current_task_group;
+      t_current_task_group = group;
+
+      // 3. 提交任务
+      // submit 内部会检测到 t_current_task_group 不为空，执行
+      // group->increment()，并将 group 打包进任务闭包。
+      // 提交被拒绝(队列已满或已关闭)时恢复上下文后重新抛出
+      try {
+        submit(std::forward<F>(f), std::forward<Args>(args)...);
+      } catch (...) {
+        t_current_task_group = prev_group;
+        throw;
+      }
+      // 4. 恢复上下文
+      // 避免影响后续在本线程提交的其他无关任务
+      t_current_task_group = prev_group;
+    }
+
+    // 5. 阻塞等待记分牌归零
+    // 此时主线程会在这里挂起，直到所有关联了该
+    // group的任务（包括子任务）全部执行完毕。
+    group->wait();
+  }
+
+  // 线程数
+  [[nodiscard]]
+  std::size_t thread_num() const {
+    return _thread_num.load(std::memory_order::acquire);
+  }
+
+  // 线程数的上限，resize 不能超过它
+  [[nodiscard]]
+  std::size_t max_thread_num() const {
+    return _max_thread_num;
+  }
+
+  // 把工作线程数调整为 n(1 到 max_thread_num)
+  // 增加时在空闲的槽位上启动线程，等新的 worker 注册好后返回；
+  // 减少时编号最大的几个 worker 把本地队列和收件箱中的任务交还给线程池后退役，
+  // 不等待它们退出(正在执行的任务照常执行完)；退役还没开始就又增加时，
+  // 撤销退役请求，worker 继续运行
+  void resize(std::size_t n) {
+    if (n == 0 || n > _max_thread_num) {
+      throw std::out_of_range{"worker count out of range"};
+    }
+    std::lock_guard lock{_control_mutex};
+    if (_shared.global_queue_closed()) {
+      throw std::runtime_error{"queue is closed"};
+    }
+    auto current = thread_num();
+    if (n < current) {
+      // 先缩小范围，新的定时器和 spawn_on 不再选中退役的 worker
+      _thread_num.store(n, std::memory_order::release);
+      _shared.set_worker_limit(n);
+      for (auto i = n; i < current; ++i) {
+        _workers[i]->request_retire();
+      }
+    } else if (n > current) {
+      std::vector<std::size_t> slots;
+      for (auto i = current; i < n; ++i) {
+        if (_threads[i].joinable()) {
+          if (_workers[i]->cancel_retire()) continue;
+          // 已经开始退役，等旧线程退出后再启动
+          _threads[i].join();
+        }
+        slots.push_back(i);
+      }
+      start_workers(slots);
+      _shared.set_worker_limit(n);
+      _thread_num.store(n, std::memory_order::release);
+    }
+  }
+
+  // 活跃的 worker 数量(没有开启动态伸缩时等于线程数)
+  [[nodiscard]]
+  std::size_t active_worker_count() const {
+    return _shared.active_worker_count();
+  }
+
+  // 线程池的调度接口，用于识别当前线程是否是本线程池的 worker
+  [[nodiscard]]
+  const Scheduler* scheduler() const {
+    return &_shared;
+  }
+
+  // 当前线程是本线程池的 worker 时返回它的 id，否则返回空
+  [[nodiscard]]
+  std::optional<std::size_t> current_worker_id() const {
+    if (auto worker = local_worker()) {
+      return worker->get_worker_id();
+    }
+    return std::nullopt;
+  }
+
+  // 错过截止时间的任务数量
+  [[nodiscard]]
+  std::size_t missed_deadlines() const {
+    return _shared.missed_deadlines();
+  }
+
+  // 全局队列满时各溢出策略生效的次数
+  [[nodiscard]]
+  OverflowStats overflow_stats() const {
+    return _shared.overflow_stats();
+  }
+
+ private:
+  // 将任务包装成 void() 类型的 job，并关联当前线程所属的任务组
+  // 返回 job 和用于获取任务执行结果的 future
+  template <typename F, typename... Args>
+  static auto make_job(F&& f, Args&&... args) {
     // 获取任务的返回类型
     using return_type = std::invoke_result_t<F, Args...>;
 
@@ -60,30 +545,13 @@ class thread_pool : public util::Singleton<thread_pool> {
     // 中（值传递，增加引用计数）sptr计数器+1
     auto task_ptr = std::make_shared<std::packaged_task<return_type()>>(
         [func = std::forward<F>(f), ... args = std::forward<Args>(args),
-         group = current_group]() -> return_type {
-          // 这是一个 RAII 辅助类，用于在任务执行期间临时设置 TLS
-          struct ContextGuard {
-            std::shared_ptr<TaskGroup> _group;
-            std::shared_ptr<TaskGroup> _prev_group;
-            explicit ContextGuard(std::shared_ptr<TaskGroup> g) : _group(g) {
-              // 保存之前的上下文（虽然通常 Worker
-              // 线程之前是空的，但为了健壮性）
-              _prev_group = t_current_task_group;
-
-              // 设置当前任务的上下文
-              t_current_task_group = _group;
-            }
-            ~ContextGuard() {
-              // 恢复之前的上下文
-              t_current_task_group = _prev_group;
-
-              // 任务结束，计数器 -1
-              if (_group) _group->decrement();
-            }
-          };
-
+         group = current_group]() mutable -> return_type {
           // 2. 恢复上下文：在任务开始执行前，设置 TLS
           ContextGuard guard(group);
+          // 被溢出策略丢弃时不执行，future 得到异常
+          if (std::exchange(t_discard_task, false)) {
+            throw std::runtime_error{"task dropped"};
+          }
 
           // 执行用户实际的函数
           return func(args...);
@@ -93,60 +561,207 @@ class thread_pool : public util::Singleton<thread_pool> {
     auto fut = task_ptr->get_future();
     // 创建一个函数对象，用于将任务包装成 void() 类型，方便 Worker 执行
     auto job = std::function<void()>([task_ptr]() { (*task_ptr)(); });
+    return std::pair{std::move(job), std::move(fut)};
+  }
 
-    // 检查当前线程是否是 Worker 线程
-    if (t_worker != nullptr) {
-      // 如果是 Worker 线程，直接加入到自己的本地队列
-      t_worker->push_back_task_to_local(std::move(job),
-                                        _shared.get_global_queue());
-    } else {
-      // 外部线程，加入到全局队列
-      t_shared->push_back_task_to_global(std::move(job));
+  // 插入定时器：Worker 线程插入自己的时间轮，
+  // 外部线程轮流选择一个时间轮，并唤醒驱动它的 worker 重新计算休眠时间
+  // 回调没有 future 可以传递异常，抛出的异常记录日志后忽略，不会终止 worker，
+  // 周期定时器照常继续
+  template <typename F, typename... Args>
+  TimerHandle insert_timer(deadline_clock::time_point when,
+                           deadline_clock::duration period, F&& f,
+                           Args&&... args) {
+    if (_shared.global_queue_closed()) {
+      throw std::runtime_error{"queue is closed"};
+    }
+    auto callback = [func = std::forward<F>(f),
+                     ... args = std::forward<Args>(args)]() mutable {
+      try {
+        std::invoke(func, args...);
+      } catch (const std::exception& e) {
+        fastlog::console.error("timer callback threw: {}", e.what());
+      } catch (...) {
+        fastlog::console.error("timer callback threw an unknown exception");
+      }
+    };
+    auto worker = local_worker();
+    auto id = worker != nullptr ? worker->get_worker_id()
+                                : _shared.next_timer_wheel();
+    auto entry =
+        _shared.timer_wheel(id).insert(when, period, std::move(callback));
+    if (worker == nullptr) {
+      _shared.get_worker(id)->unpark();
+    }
+    return TimerHandle{std::move(entry)};
+  }
+
+  // 构造文件操作，数据位于注册缓冲区内时使用固定缓冲区读写
+  FileOp make_file_op(FileOp::Kind kind, int fd, std::byte* data,
+                      std::size_t size, std::uint64_t offset) {
+    return FileOp{kind, fd, data, size, offset,
+                  _file_io.registered_index(data, size)};
+  }
+
+  // 提交文件操作，完成后以结果调用 f，关联当前任务组
+  template <typename F>
+  std::future<std::invoke_result_t<F, std::int64_t>> submit_file_op(
+      const FileOp& op, F&& f) {
+    using return_type = std::invoke_result_t<F, std::int64_t>;
+    auto current_group = t_current_task_group;
+    if (current_group) {
+      current_group->increment();
+    }
+    auto task_ptr =
+        std::make_shared<std::packaged_task<return_type(std::int64_t)>>(
+            std::forward<F>(f));
+    auto fut = task_ptr->get_future();
+    try {
+      _file_io.submit(
+          op,
+          [task_ptr, group = current_group](std::int64_t res) {
+            ContextGuard guard(group);
+            (*task_ptr)(res);
+          },
+          local_worker() != nullptr);
+    } catch (...) {
+      if (current_group) current_group->decrement();
+      throw;
     }
     return fut;
   }
 
- private:
-  // 构造函数，创建线程池并初始化工作者
-  explicit thread_pool() noexcept {
-    // 启动工作线程
-    work();
+  // 把文件 I/O 的完成回调交给线程池，线程池已关闭时在当前线程执行
+  void schedule_completion(std::function<void()> job) {
+    try {
+      schedule(job);
+    } catch (const std::runtime_error&) {
+      job();
+    }
   }
 
-  // 工作函数，创建线程并运行工作者
-  void work() {
-    for (std::size_t i = 0; i < _thread_num; ++i) {
-      _threads.emplace_back([this, i]() {
-        detail::Worker worker{&_shared, i};
-        // 等待所有的worker全部创建完成(shared内的worker数组完整注册好)
-        sync_start.arrive_and_wait();
-        // 统一启动run
-        worker.run();
-      });
+  // 把已经包装好的 job 放入队列：Worker 线程放入本地队列，否则放入全局队列
+  void schedule(std::function<void()> job) {
+    if (auto worker = local_worker()) {
+      worker->push_back_task_to_local(std::move(job));
+    } else {
+      _shared.push_back_task_to_global(std::move(job));
     }
-    // 等待所有线程启动完成，此函数才执行完成
-    sync_start.arrive_and_wait();
   }
 
-  bool task_complete() {
-    auto workers = _shared.get_workers();
-    for (auto w : workers) {
-      if (w->is_worker_has_task() || !_shared.is_global_queue_empty()) {
-        return false;
+  // 关闭、重新启动线程池要等待 worker 线程，不能在 worker 线程上进行
+  void check_not_worker() const {
+    if (local_worker() != nullptr) {
+      throw std::runtime_error{"cannot shut down from a worker thread"};
+    }
+  }
+
+  // 关闭线程池，并丢弃全局队列、本地队列和阻塞任务线程池中排队的任务
+  void abort() {
+    _shared.abort_queued_tasks();
+    _shared.global_queue_close();
+    _blocking.abort();
+  }
+
+  // 等待所有 worker 线程和阻塞任务线程退出(需要先关闭，调用方持有控制锁)，
+  // 没有启动过或已经 join 过的槽位跳过；之后丢弃未到期的定时器
+  void join_workers() {
+    for (auto& thread : _threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    _blocking.join();
+    _shared.clear_timers();
+  }
+
+  // 当前线程是本线程池的 Worker 时返回它，否则返回空
+  Worker<Policy>* local_worker() const {
+    auto worker = t_worker<Policy>;
+    return (worker != nullptr && worker->belongs_to(&_shared)) ? worker
+                                                               : nullptr;
+  }
+
+  // 在指定的槽位上创建线程并运行工作者，等它们的 Worker 都注册好后返回
+  template <std::ranges::input_range R>
+  void start_workers(R&& slots) {
+    std::vector<std::future<void>> started;
+    for (std::size_t i : slots) {
+      std::promise<void> ready;
+      started.push_back(ready.get_future());
+      {
+        std::lock_guard lock{_exit_mutex};
+        ++_running_threads;
       }
+      _threads[i] = std::jthread([this, i, ready = std::move(ready)]() mutable {
+        // 命名并按亲和性策略绑定线程，需要在构造 Worker 之前完成，
+        // 这样 Worker 和它的本地队列会在所绑定 CPU 的 NUMA 节点上分配
+        set_current_thread_name(_options.thread_name + "-w" +
+                                std::to_string(i));
+        if (_options.affinity != AffinityPolicy::none &&
+            !bind_current_thread_to_cpu(_placement[i].cpu)) {
+          fastlog::console.warn("worker {} failed to bind to cpu {}", i,
+                                _placement[i].cpu);
+        }
+        // 槽位第一次启动时创建 Worker，退役后重新启动时复用
+        if (_workers[i] == nullptr) {
+          _workers[i] = std::make_unique<Worker<Policy>>(&_shared, i, _options);
+        }
+        auto& worker = *_workers[i];
+        ready.set_value();
+        worker.run();
+        {
+          std::lock_guard lock{_exit_mutex};
+          --_running_threads;
+        }
+        _exit_cv.notify_all();
+      });
+    }
+    // 等待所有线程启动完成，此函数才执行完成
+    for (auto& future : started) {
+      future.get();
     }
-    return true;
   }
 
  private:
-  std::size_t _thread_num{std::thread::hardware_concurrency()};  // 线程数
-  std::vector<std::jthread> _threads{};                          // 线程池
-  Shared _shared{_thread_num};                                   // 共享状态
-  std::atomic<std::size_t> _rr_index{0};                         // 轮询索引
-  std::latch sync_start{
-      static_cast<std::ptrdiff_t>(_thread_num + 1)};  // 同步标志
+  PoolOptions _options{};  // 线程池配置
+  std::size_t _max_thread_num{std::max(
+      {std::size_t{1}, _options.thread_num,
+       _options.max_thread_num != 0
+           ? _options.max_thread_num
+           : std::size_t{std::thread::hardware_concurrency()}})};  // 线程数上限
+  std::atomic<std::size_t> _thread_num{
+      std::max<std::size_t>(1, _options.thread_num)};  // 线程数
+  BlockingPool _blocking{_options.max_blocking_threads,
+                         _options.blocking_keep_alive,
+                         _options.thread_name};        // 阻塞任务线程池
+  std::vector<std::jthread> _threads =
+      std::vector<std::jthread>(_max_thread_num);  // 各槽位的线程
+  std::mutex _control_mutex{};  // 串行化 resize、shutdown 和 restart
+  std::mutex _exit_mutex{};               // 保护运行中的 worker 线程数
+  std::condition_variable _exit_cv{};     // 通知 worker 线程退出
+  std::size_t _running_threads{0};        // 运行中的 worker 线程数
+  Topology _topology{Topology::detect()};          // CPU 拓扑
+  std::vector<CpuInfo> _placement{place_workers(
+      _topology, _max_thread_num, _options.affinity,
+      _options.cpu_list)};  // 各槽位的位置
+  Shared<Policy> _shared{_topology, _placement,
+                         _options.affinity != AffinityPolicy::none,
+                         _options.global_queue_capacity,
+                         _options.overflow_policy,
+                         _options.scaling};  // 共享状态
+  FileIo _file_io{_shared.reactor(), _blocking,
+                  [this](std::function<void()> job) {
+                    schedule_completion(std::move(job));
+                  }};  // 文件 I/O
+  std::atomic<std::size_t> _rr_index{0};  // 轮询索引
+  // 各槽位的 Worker，属于线程池，退役后保留，在 _shared 之前析构
+  std::vector<std::unique_ptr<Worker<Policy>>> _workers =
+      std::vector<std::unique_ptr<Worker<Policy>>>(_max_thread_num);
 };
 
+// 默认调度策略的线程池
+using thread_pool = basic_thread_pool<>;
 }  // namespace fastexec::detail
 
 #endif
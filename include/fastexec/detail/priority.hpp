@@ -0,0 +1,27 @@
+#ifndef __FASTSTDEXEC_DETAIL_PRIORITY_HPP
+#define __FASTSTDEXEC_DETAIL_PRIORITY_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace fastexec::detail {
+// 任务优先级，数值越小优先级越高，同时也是各级队列的下标
+enum class Priority : std::size_t {
+  high = 0,        // 延迟敏感的任务
+  normal = 1,      // 默认优先级
+  background = 2,  // 后台任务(压缩、清理等)
+};
+
+// 优先级级数
+inline constexpr std::size_t PRIORITY_LEVELS = 3;
+
+// 优先级对应的队列下标
+constexpr std::size_t level_of(Priority priority) {
+  return static_cast<std::size_t>(priority);
+}
+
+// 截止时间任务使用的时钟，截止时间是该时钟上的绝对时间点
+using deadline_clock = std::chrono::steady_clock;
+}  // namespace fastexec::detail
+
+#endif
@@ -1,23 +1,38 @@
 #ifndef __FASTSTDEXEC_DETAIL_QUEUE_HPP
 #define __FASTSTDEXEC_DETAIL_QUEUE_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "fastlog/fastlog.hpp"
+#include "policy.hpp"
+#include "priority.hpp"
 #include "util.hpp"
 namespace fastexec::detail {
-// 非阻塞全局队列：基于互斥锁，但是不基于条件变量
+// 非阻塞全局队列：基于互斥锁，worker 取任务不基于条件变量
+// 可以设置容量，只有提交新任务时检查(try_push_back 等)，push_back 不受限制，
+// 用于协程恢复、溢出转移等已经被接纳的任务；
+// 容量满时外部提交线程可以在条件变量上等待空间(溢出策略 block)
 class GlobalQueue : util::noncopyable {
  public:
-  explicit GlobalQueue() = default;
+  explicit GlobalQueue(std::size_t capacity = 0) : _capacity(capacity) {}
 
   ~GlobalQueue() {
     if (!closed()) close();
@@ -29,30 +44,109 @@ class GlobalQueue : util::noncopyable {
     return _closed;
   }
 
-  void close() { _closed.store(true); }
+  void close() {
+    {
+      auto lock = get_lock();
+      _closed.store(true);
+    }
+    _not_full.notify_all();
+  }
+
+  // 重新打开已经关闭的队列，线程池重新启动时调用
+  void reopen() {
+    auto lock = get_lock();
+    _closed.store(false);
+  }
+
+  // 队列容量，0 表示不限制
+  [[nodiscard]]
+  std::size_t capacity() const {
+    return _capacity;
+  }
 
+  // 是否还能放下 n 个任务，不加锁读取，只是一个近似值
+  [[nodiscard]]
+  bool has_room(std::size_t n = 1) const {
+    return _capacity == 0 || size() + n <= _capacity;
+  }
+
+  // 队列长度，不加锁读取，只是一个近似值
   [[nodiscard]]
   std::size_t size() const {
-    auto lock = get_lock();
-    return _queue.size();
+    return _size.load(std::memory_order::acquire);
   }
 
+  // 队列是否为空，不加锁读取，worker 空闲轮询时不会争抢队列锁
   [[nodiscard]]
   bool empty() const {
-    auto lock = get_lock();
-    return _queue.empty();
+    return size() == 0;
   }
 
   void push_back(std::function<void()> task) {
     if (closed()) throw std::runtime_error{"queue is closed"};
     auto lock = get_lock();
     _queue.push_back(std::move(task));
+    _size.store(_queue.size(), std::memory_order::release);
   }
 
   void push_back_batch(std::span<std::function<void()>> tasks) {
     if (closed()) throw std::runtime_error{"queue is closed"};
     auto lock = get_lock();
-    _queue.insert(_queue.end(), tasks.begin(), tasks.end());
+    _queue.insert(_queue.end(), std::make_move_iterator(tasks.begin()),
+                  std::make_move_iterator(tasks.end()));
+    _size.store(_queue.size(), std::memory_order::release);
+  }
+
+  // 有空间时放入任务并返回 true，队列已满时返回 false(task 不变)
+  bool try_push_back(std::function<void()>& task) {
+    if (closed()) throw std::runtime_error{"queue is closed"};
+    auto lock = get_lock();
+    if (_capacity != 0 && _queue.size() >= _capacity) return false;
+    _queue.push_back(std::move(task));
+    _size.store(_queue.size(), std::memory_order::release);
+    return true;
+  }
+
+  // 放入能放下的前若干个任务，返回放入的数量
+  std::size_t try_push_back_batch(std::span<std::function<void()>> tasks) {
+    if (closed()) throw std::runtime_error{"queue is closed"};
+    auto lock = get_lock();
+    auto n = tasks.size();
+    if (_capacity != 0) {
+      n = std::min(n, _capacity - std::min(_capacity, _queue.size()));
+    }
+    _queue.insert(_queue.end(), std::make_move_iterator(tasks.begin()),
+                  std::make_move_iterator(tasks.begin() + n));
+    _size.store(_queue.size(), std::memory_order::release);
+    return n;
+  }
+
+  // 等待到有空间后放入任务，队列在等待期间关闭时抛出异常
+  void push_back_wait(std::function<void()> task) {
+    std::unique_lock lock{_mutex};
+    ++_waiting;
+    _not_full.wait(lock, [this] {
+      return closed() || _capacity == 0 || _queue.size() < _capacity;
+    });
+    --_waiting;
+    if (closed()) throw std::runtime_error{"queue is closed"};
+    _queue.push_back(std::move(task));
+    _size.store(_queue.size(), std::memory_order::release);
+  }
+
+  // 取出最早的任务并把 task 放到队尾，队列为空时直接放入并返回空
+  auto replace_oldest(std::function<void()> task)
+      -> std::optional<std::function<void()>> {
+    if (closed()) throw std::runtime_error{"queue is closed"};
+    auto lock = get_lock();
+    std::optional<std::function<void()>> oldest{};
+    if (!_queue.empty()) {
+      oldest = std::move(_queue.front());
+      _queue.pop_front();
+    }
+    _queue.push_back(std::move(task));
+    _size.store(_queue.size(), std::memory_order::release);
+    return oldest;
   }
 
   auto try_pop() -> std::optional<std::function<void()>> {
@@ -60,6 +154,8 @@ class GlobalQueue : util::noncopyable {
     if (_queue.empty()) return std::nullopt;
     auto task = std::move(_queue.front());
     _queue.pop_front();
+    _size.store(_queue.size(), std::memory_order::release);
+    if (_waiting != 0) _not_full.notify_one();
     return task;
   }
   // 尝试批量弹出任务
@@ -75,6 +171,8 @@ class GlobalQueue : util::noncopyable {
       tasks.push_back(std::move(_queue.front()));
       _queue.pop_front();
     }
+    _size.store(_queue.size(), std::memory_order::release);
+    if (_waiting != 0) _not_full.notify_all();
     return tasks;
   }
 
@@ -87,7 +185,229 @@ class GlobalQueue : util::noncopyable {
  private:
   mutable std::mutex _mutex{};                 // 互斥锁，用于保护队列
   std::deque<std::function<void()>> _queue{};  // 任务队列
+  std::atomic<std::size_t> _size{0};           // 队列长度(在锁内更新)
   std::atomic<bool> _closed{false};            // 队列是否关闭
+  std::size_t _capacity;                       // 容量，0 表示不限制
+  std::condition_variable _not_full{};         // 等待空间的提交线程
+  std::size_t _waiting{0};  // 等待空间的提交线程数量(在锁内更新)
+};
+
+// 无锁多生产者单消费者队列(Vyukov)：每个 worker 一个，作为指定 worker 执行的
+// 任务的收件箱；任何线程都可以放入，只有所属 worker 取出，按放入顺序执行
+// 放入只有一次原子交换，队列为空或生产者正在链接节点时取出返回空
+class MpscQueue : util::noncopyable {
+ public:
+  MpscQueue() : _stub(new Node{}), _head(_stub), _tail(_stub) {}
+
+  ~MpscQueue() {
+    while (_tail != nullptr) {
+      delete std::exchange(_tail, _tail->_next.load(std::memory_order::relaxed));
+    }
+  }
+
+ public:
+  // 队列长度，不加锁读取，只是一个近似值
+  [[nodiscard]]
+  std::size_t size() const {
+    return _size.load(std::memory_order::acquire);
+  }
+
+  [[nodiscard]]
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // 放入任务(任何线程)
+  void push(std::function<void()> task) {
+    auto node = new Node{std::move(task)};
+    auto prev = _head.exchange(node, std::memory_order::acq_rel);
+    prev->_next.store(node, std::memory_order::release);
+    _size.fetch_add(1, std::memory_order::seq_cst);
+  }
+
+  // 取出任务(只能由所属 worker 调用)
+  std::optional<std::function<void()>> try_pop() {
+    auto next = _tail->_next.load(std::memory_order::acquire);
+    if (next == nullptr) return std::nullopt;
+    // 取出的节点成为新的哨兵节点，原来的哨兵节点释放
+    auto task = std::move(next->_task);
+    delete std::exchange(_tail, next);
+    _size.fetch_sub(1, std::memory_order::relaxed);
+    return task;
+  }
+
+ private:
+  struct Node {
+    std::function<void()> _task{};
+    std::atomic<Node*> _next{nullptr};
+  };
+
+ private:
+  Node* _stub;                              // 初始的哨兵节点
+  alignas(64) std::atomic<Node*> _head;     // 最后放入的节点(生产者)
+  alignas(64) Node* _tail;                  // 哨兵节点，下一个节点是队首(消费者)
+  std::atomic<std::size_t> _size{0};        // 队列长度
+};
+
+// 空闲 worker 栈：无锁栈，元素是 worker id，worker 休眠时把自己压入，
+// 外部线程提交任务时弹出一个空闲 worker 直接交给它
+// 栈顶指针高 32 位是版本号，每次修改加 1，避免 ABA 问题；
+// 每个 worker 同时只会在栈中出现一次，弹出的 worker 可能已经醒来(过期)，
+// 由调用者确认它是否仍在休眠
+class IdleStack : util::noncopyable {
+ public:
+  explicit IdleStack(std::size_t worker_num)
+      : _next(worker_num), _listed(worker_num) {}
+
+ public:
+  // 压入 worker(已经在栈中时忽略)
+  void push(std::size_t worker_id) {
+    if (_listed[worker_id].exchange(true, std::memory_order::acq_rel)) return;
+    auto head = _head.load(std::memory_order::relaxed);
+    auto node = static_cast<std::uint64_t>(worker_id + 1);
+    do {
+      _next[worker_id].store(head & INDEX_MASK, std::memory_order::relaxed);
+    } while (!_head.compare_exchange_weak(head, pack(version(head) + 1, node),
+                                          std::memory_order::release,
+                                          std::memory_order::relaxed));
+  }
+
+  // 弹出最近压入的 worker，栈为空时返回空
+  std::optional<std::size_t> pop() {
+    auto head = _head.load(std::memory_order::acquire);
+    while ((head & INDEX_MASK) != 0) {
+      auto worker_id = static_cast<std::size_t>((head & INDEX_MASK) - 1);
+      auto next = _next[worker_id].load(std::memory_order::relaxed);
+      if (_head.compare_exchange_weak(head, pack(version(head) + 1, next),
+                                      std::memory_order::acq_rel,
+                                      std::memory_order::acquire)) {
+        _listed[worker_id].store(false, std::memory_order::release);
+        return worker_id;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // 栈是否为空，不加锁读取，只是一个近似值
+  [[nodiscard]]
+  bool empty() const {
+    return (_head.load(std::memory_order::relaxed) & INDEX_MASK) == 0;
+  }
+
+ private:
+  constexpr static std::uint64_t INDEX_MASK = 0xFFFF'FFFF;
+
+  static std::uint64_t version(std::uint64_t head) { return head >> 32; }
+  static std::uint64_t pack(std::uint64_t version, std::uint64_t index) {
+    return (version << 32) | index;
+  }
+
+ private:
+  // 栈顶：高 32 位版本号，低 32 位为 worker id + 1(0 表示空栈)
+  std::atomic<std::uint64_t> _head{0};
+  std::vector<std::atomic<std::uint64_t>> _next;  // 每个 worker 的下一个节点
+  std::vector<std::atomic<bool>> _listed;         // worker 是否在栈中
+};
+
+// 截止时间队列：基于互斥锁的最小堆，总是弹出截止时间最早的任务(EDF)
+// 截止时间相同的任务按入队顺序弹出
+// 堆顶的截止时间和队列长度用原子变量发布，窃取者不加锁就能比较各个队列
+class DeadlineQueue : util::noncopyable {
+ public:
+  using rep = deadline_clock::rep;
+
+  // 空队列的堆顶截止时间
+  constexpr static inline rep NO_DEADLINE = std::numeric_limits<rep>::max();
+
+ public:
+  // 队列长度，不加锁读取，只是一个近似值
+  [[nodiscard]]
+  std::size_t size() const {
+    return _size.load(std::memory_order::acquire);
+  }
+
+  [[nodiscard]]
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // 堆顶任务的截止时间(时钟计数)，空队列返回 NO_DEADLINE，不加锁读取
+  [[nodiscard]]
+  rep earliest() const {
+    return _earliest.load(std::memory_order::acquire);
+  }
+
+  void push(deadline_clock::time_point deadline, std::function<void()> task) {
+    auto lock = get_lock();
+    _heap.push_back(Entry{deadline.time_since_epoch().count(), _seq++,
+                          std::move(task)});
+    std::ranges::push_heap(_heap, later);
+    publish();
+  }
+
+  // 弹出截止时间最早的任务
+  auto try_pop() -> std::optional<std::function<void()>> {
+    auto lock = get_lock();
+    if (_heap.empty()) return std::nullopt;
+    std::ranges::pop_heap(_heap, later);
+    auto task = std::move(_heap.back()._task);
+    _heap.pop_back();
+    publish();
+    return task;
+  }
+
+  // 把所有任务转移到 other，保持截止时间和相同截止时间的先后顺序，
+  // 返回转移的任务数
+  std::size_t move_to(DeadlineQueue& other) {
+    std::vector<Entry> entries;
+    {
+      auto lock = get_lock();
+      entries.swap(_heap);
+      publish();
+    }
+    std::ranges::sort(entries, [](const Entry& a, const Entry& b) {
+      return later(b, a);
+    });
+    auto lock = other.get_lock();
+    for (auto& entry : entries) {
+      other._heap.push_back(
+          Entry{entry._deadline, other._seq++, std::move(entry._task)});
+      std::ranges::push_heap(other._heap, later);
+    }
+    other.publish();
+    return entries.size();
+  }
+
+ private:
+  struct Entry {
+    rep _deadline;
+    std::uint64_t _seq;
+    std::function<void()> _task;
+  };
+
+  // 堆的比较函数，a 比 b 晚到期时返回 true，堆顶是最早到期的任务
+  static bool later(const Entry& a, const Entry& b) {
+    return a._deadline != b._deadline ? a._deadline > b._deadline
+                                      : a._seq > b._seq;
+  }
+
+  // 在锁内发布堆顶截止时间和队列长度
+  void publish() {
+    _earliest.store(_heap.empty() ? NO_DEADLINE : _heap.front()._deadline,
+                    std::memory_order::release);
+    _size.store(_heap.size(), std::memory_order::release);
+  }
+
+  auto get_lock() const -> std::lock_guard<std::mutex> {
+    return std::lock_guard<std::mutex>{_mutex};
+  }
+
+ private:
+  mutable std::mutex _mutex{};              // 互斥锁，用于保护堆
+  std::vector<Entry> _heap{};               // 按截止时间排列的最小堆
+  std::uint64_t _seq{0};                    // 入队序号
+  std::atomic<rep> _earliest{NO_DEADLINE};  // 堆顶截止时间(在锁内更新)
+  std::atomic<std::size_t> _size{0};        // 队列长度(在锁内更新)
 };
 
 // 本地队列 ，基于array,无锁，支持窃取操作
@@ -95,28 +415,55 @@ class GlobalQueue : util::noncopyable {
 // 所以将头指针拆成两部分，加上通过cas更新，来保证线程安全
 // 正常单线程操作情况：头指针两部分相等。
 // 有其他线程操作队列的时候(窃取该队列)：两部分不相等
-template <std::size_t CAPACITY = 256>
+// 运行时指定容量时可以设置最大容量，队列满时拥有者先把数组扩大一倍，
+// 到达最大容量后才把一半任务转移到全局队列
+// 每次被窃取目标队列任务数的 1/STEAL_DIVISOR(至少一个，但总给拥有者留一个)
+template <std::size_t CAPACITY = 256, std::size_t STEAL_DIVISOR = 2>
 class LocalQueue {
   static_assert((CAPACITY & (CAPACITY - 1)) == 0,
                 "CAPACITY must be power of 2");
-  static_assert(CAPACITY > 0, "CAPACITY must be greater than 0");
+  static_assert(STEAL_DIVISOR >= 2, "STEAL_DIVISOR must be at least 2");
 
  public:
-  LocalQueue() = default;
+  LocalQueue()
+    requires(CAPACITY != dynamic_capacity)
+  = default;
+  // 运行时指定容量，向上取整到 2 的幂
+  // max_capacity 大于容量时队列满了可以扩容，最大到 max_capacity(向下取整到 2 的幂)
+  explicit LocalQueue(std::size_t capacity, std::size_t max_capacity = 0)
+    requires(CAPACITY == dynamic_capacity)
+      : _capacity(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+        _max_capacity(std::max(
+            _capacity, std::bit_floor(std::min(max_capacity, MAX_CAPACITY)))),
+        _tasks(std::make_unique<std::function<void()>[]>(_capacity)) {}
   ~LocalQueue() = default;
 
  public:
   [[nodiscard]]
   std::size_t capacity() const {
-    return CAPACITY;
+    if constexpr (CAPACITY != dynamic_capacity) {
+      return CAPACITY;
+    } else {
+      return _capacity;
+    }
+  }
+  // 扩容后能达到的最大容量，等于 capacity() 时不扩容
+  [[nodiscard]]
+  std::size_t max_capacity() const {
+    if constexpr (CAPACITY != dynamic_capacity) {
+      return CAPACITY;
+    } else {
+      return _max_capacity;
+    }
   }
+
   // 返回队列中剩余可用空间的数量
   [[nodiscard]]
   std::size_t remain_size() {
     auto tail = _tail.load(std::memory_order::acquire);
     auto head = _head.load(std::memory_order::acquire);
     auto [steal, local_head] = unpack(head);
-    return CAPACITY - static_cast<std::uint64_t>(tail - steal);
+    return capacity() - static_cast<std::uint64_t>(tail - steal);
   }
 
   // 返回队列中当前任务数量
@@ -140,7 +487,7 @@ class LocalQueue {
     auto [steal, _] = unpack(_head.load(std::memory_order::acquire));
     auto tail = _tail.load(std::memory_order::relaxed);
     for (auto&& task : tasks) {
-      std::size_t idx = tail & _mask;
+      std::size_t idx = tail & mask();
       _tasks[idx] = std::move(task);
       tail += 1;
     }
@@ -158,12 +505,17 @@ class LocalQueue {
       auto [steal, local_head] = unpack(head);
       tail = _tail.load(std::memory_order::acquire);
       // 如果尾指针与窃取指针的差值小于队列容量，说明队列未满，直接跳出循环
-      if (tail - steal < static_cast<std::uint32_t>(CAPACITY)) {
+      if (tail - steal < static_cast<std::uint32_t>(capacity())) {
         break;
       } else if (steal != local_head) {
         // 队列已满,且头指针与实际头指针不同,说明有其他线程在窃取任务
         // 尝试将任务推送到全局队列
         global_queue.push_back(std::move(task));
+        return;
+      } else if (capacity() < max_capacity()) {
+        // 还能扩容，扩容后重新检查(有线程正在窃取导致扩容失败时同样重新检查)
+        try_grow();
+        continue;
       } else {
         // 正常调用处理溢出
         if (handle_overflow(task, local_head, tail, global_queue)) {
@@ -172,10 +524,45 @@ class LocalQueue {
       }
     }
     // step 2 : 将任务存储在数组中,更新头指针
-    _tasks[tail & _mask] = std::move(task);
+    _tasks[tail & mask()] = std::move(task);
     _tail.store(tail + 1, std::memory_order::release);
   }
 
+  // 扩大数组，使队列至少还能放下 n 个任务(只能由拥有者调用)
+  // 先把头指针的两部分置为不相等，窃取者看到后会放弃窃取，
+  // 而正在窃取的线程会让这一步失败，所以搬移任务时没有其他线程读取旧数组，
+  // 旧数组可以立即释放；有线程正在窃取或已到最大容量时返回 false
+  bool try_grow(std::size_t n = 1) {
+    if constexpr (CAPACITY != dynamic_capacity) {
+      return false;
+    } else {
+      auto head = _head.load(std::memory_order::acquire);
+      auto [steal, local_head] = unpack(head);
+      if (steal != local_head) return false;
+      auto tail = _tail.load(std::memory_order::relaxed);
+      auto need = static_cast<std::size_t>(tail - local_head) + n;
+      auto new_capacity =
+          std::min(std::max(std::bit_ceil(need), _capacity * 2), _max_capacity);
+      if (new_capacity <= _capacity || new_capacity < need) return false;
+      // 先分配，分配失败时队列保持不变
+      auto tasks = std::make_unique<std::function<void()>[]>(new_capacity);
+      if (!_head.compare_exchange_strong(head, pack(local_head - 1, local_head),
+                                         std::memory_order::acquire,
+                                         std::memory_order::relaxed)) {
+        return false;
+      }
+      // 任务保持原来的逻辑下标，头尾指针不变
+      for (auto i = local_head; i != tail; ++i) {
+        tasks[i & (new_capacity - 1)] = std::move(_tasks[i & mask()]);
+      }
+      _tasks = std::move(tasks);
+      _capacity = new_capacity;
+      // 恢复头指针，之后成功窃取的线程都能看到新数组
+      _head.store(head, std::memory_order::release);
+      return true;
+    }
+  }
+
   // 尝试从队列头部弹出任务
   // 这个队列是多消费者队列，所以需要用cas操作来更新头指针。
   std::optional<std::function<void()>> try_pop() {
@@ -200,7 +587,7 @@ class LocalQueue {
                                         std::memory_order::acq_rel,
                                         std::memory_order::acquire)) {
           // 成功，获得当前任务的索引,并且退出循环
-          index = static_cast<std::size_t>(cur_local_head) & _mask;
+          index = static_cast<std::size_t>(cur_local_head) & mask();
           break;
         }
       }
@@ -217,11 +604,14 @@ class LocalQueue {
         unpack(dst_queue._head.load(std::memory_order::acquire));
     auto dst_tail = dst_queue._tail.load(std::memory_order::acquire);
     // 如果目标队列的已有任务大于队列容量的一半,无法进行窃取操作，直接返回空
-    if (dst_tail - dst_steal > static_cast<std::uint32_t>(CAPACITY) / 2) {
+    // 只读取目标队列(窃取者自己)的容量，当前队列的容量可能正在被拥有者扩大
+    auto dst_capacity = static_cast<std::uint32_t>(dst_queue.capacity());
+    if (dst_tail - dst_steal > dst_capacity / 2) {
       return result;
     }
-    // 进行窃取并且更新头指针
-    auto steal_num = be_stolen_by_impl(dst_queue, dst_tail);
+    // 进行窃取并且更新头指针，最多窃取目标队列剩余空间大小的任务
+    auto steal_num =
+        be_stolen_by_impl(dst_queue, dst_tail, dst_capacity - (dst_tail - dst_steal));
 
     // 如果窃取数量为0,说明没有任务被窃取,直接返回空
     if (steal_num == 0) {
@@ -232,7 +622,7 @@ class LocalQueue {
     // 得到新的目标队列尾指针
     auto next_dst_tail = dst_tail + steal_num;
     // 得到最后一个任务的索引
-    auto idx = static_cast<std::size_t>(next_dst_tail) & _mask;
+    auto idx = static_cast<std::size_t>(next_dst_tail) & dst_queue.mask();
     // 填充结果，最后一个被窃取的任务
     result.emplace(std::move(dst_queue._tasks[idx]));
     // 如果窃取数量仍然大于0,更新目标队列的尾指针
@@ -249,7 +639,7 @@ class LocalQueue {
                        std::uint32_t tail, GlobalQueue& global_queue) {
     // step1 : 更新头指针
     // 1.获取到队列容量的一半作为默认转移的数量
-    auto take_len = static_cast<std::uint32_t>(CAPACITY / 2);
+    auto take_len = static_cast<std::uint32_t>(capacity() / 2);
     assert(tail - local_head);
     // 2.打包当前头指针
     auto cur_head = pack(local_head, local_head);
@@ -266,7 +656,7 @@ class LocalQueue {
     // 1.将take_len数量的任务从本地队列转移到一个临时定义的vector内
     std::vector<std::function<void()>> tasks;
     for (int i = 0; i < take_len; i++) {
-      std::size_t idx = static_cast<std::size_t>(local_head + i) & _mask;
+      std::size_t idx = static_cast<std::size_t>(local_head + i) & mask();
       tasks.push_back(std::move(_tasks[idx]));
     }
     // 2.将触发溢出的任务添加到vector内
@@ -282,7 +672,8 @@ class LocalQueue {
   // 1.将当前队列任务的一半所为窃取任务数量，保持窃取指针不变，得到新的本地头指针(当前头指针+窃取数量)，打包成完成头指针通过cas更新
   // 2.根据窃取数量，目标队列窃取当前队列的任务
   // 3.获取到之前更新后的头指针作为当前指针，更新当前队列的窃取指针，将窃取指针等于本地头指针，合并成一个64位整数，通过cas更新
-  std::uint32_t be_stolen_by_impl(LocalQueue& dst, std::uint32_t dst_tail) {
+  std::uint32_t be_stolen_by_impl(LocalQueue& dst, std::uint32_t dst_tail,
+                                  std::uint32_t max_num) {
     // step1 :
     // 更新整体头指针-更新本地头指针，窃取指针不动,告诉其他线程我开始窃取任务了
     std::uint64_t cur_src_head = _head.load(std::memory_order::acquire);
@@ -297,8 +688,10 @@ class LocalQueue {
         return 0;
       }
       // 1. 计算当前队列中可窃取的任务数量
-      // 2. 取当前队列大小的一半作为窃取数量
-      steal_num = cur_src_size / 2;
+      // 2. 取当前队列大小的 1/STEAL_DIVISOR 作为窃取数量
+      steal_num = cur_src_size / STEAL_DIVISOR;
+      if (steal_num == 0 && cur_src_size > 1) steal_num = 1;
+      steal_num = std::min(steal_num, max_num);
       if (steal_num == 0) {
         return 0;
       }
@@ -320,8 +713,8 @@ class LocalQueue {
     auto [next_src_steal, next_src_local_head] = unpack(next_src_head);
     for (std::uint32_t i = 0; i < steal_num; i++) {
       // 2.将窃取到的任务移动到目标队列的对应位置
-      auto src_idx = static_cast<std::uint32_t>(next_src_steal + i) & _mask;
-      auto dst_idx = static_cast<std::uint32_t>(dst_tail + i) & _mask;
+      auto src_idx = static_cast<std::uint32_t>(next_src_steal + i) & mask();
+      auto dst_idx = static_cast<std::uint32_t>(dst_tail + i) & dst.mask();
       dst._tasks[dst_idx] = std::move(_tasks[src_idx]);
     }
 
@@ -344,8 +737,11 @@ class LocalQueue {
   }
 
  private:
-  constexpr static inline std::size_t _mask =
-      CAPACITY - 1;  // 掩码，用于取模操作
+  // 掩码，用于取模操作
+  [[nodiscard]]
+  std::size_t mask() const {
+    return capacity() - 1;
+  }
   /*
    * 功能 ：将两个32位整数合并成一个64位整数
    * 实现原理 ：
@@ -372,7 +768,17 @@ class LocalQueue {
   }
 
  private:
-  std::array<std::function<void()>, CAPACITY> _tasks{};  // 固定数组存放任务
+  // 容量固定时使用 std::array，容量在运行时指定时使用堆上分配的数组
+  using storage_type =
+      std::conditional_t<CAPACITY != dynamic_capacity,
+                         std::array<std::function<void()>, CAPACITY>,
+                         std::unique_ptr<std::function<void()>[]>>;
+  // 运行时指定容量时的最大容量上限，保证 32 位的头尾指针差值不会溢出
+  constexpr static inline std::size_t MAX_CAPACITY = std::size_t{1} << 30;
+
+  std::size_t _capacity{CAPACITY};  // 容量(仅运行时指定容量时使用)
+  std::size_t _max_capacity{CAPACITY};  // 扩容的上限(仅运行时指定容量时使用)
+  storage_type _tasks{};            // 固定数组存放任务
   std::atomic<std::uint64_t> _head{};  // 64位头指针，用于生产和窃取任务
   std::atomic<std::uint32_t> _tail{};  // 32位尾指针，用于消费任务
 };
@@ -0,0 +1,242 @@
+#ifndef __FASTSTDEXEC_DETAIL_REACTOR_HPP
+#define __FASTSTDEXEC_DETAIL_REACTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "coro.hpp"
+#include "util.hpp"
+namespace fastexec::detail {
+// 等待的 fd 就绪类型
+enum class Readiness {
+  readable,  // 可读(对端关闭、出错时同样视为就绪)
+  writable,  // 可写
+};
+
+// 基于 epoll 的 reactor，每个线程池一个
+// 等待是一次性的：fd 就绪后对应的回调被取出，由驱动 reactor 的 worker
+// 作为任务放入本地队列；同一个 fd 可以同时等待可读和可写
+// 空闲的 worker 中最多一个阻塞在 epoll_wait 上(poller)，
+// 其他 worker 休眠，唤醒 poller 时写 eventfd
+class Reactor : util::noncopyable {
+ public:
+  Reactor() {
+#ifdef __linux__
+    _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    _wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_epoll_fd >= 0 && _wake_fd >= 0) {
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.fd = _wake_fd;
+      ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_fd, &event);
+    }
+#endif
+  }
+
+  ~Reactor() {
+#ifdef __linux__
+    if (_wake_fd >= 0) ::close(_wake_fd);
+    if (_epoll_fd >= 0) ::close(_epoll_fd);
+#endif
+  }
+
+ public:
+  // 是否有等待中的 fd，没有时 worker 不需要驱动 reactor
+  [[nodiscard]]
+  bool has_waiters() const {
+    return _waiter_count.load(std::memory_order::acquire) > 0;
+  }
+
+  // fd 就绪时调用 callback(一次性)
+  void add_waiter(int fd, Readiness readiness, std::function<void()> callback) {
+#ifdef __linux__
+    if (_epoll_fd < 0) throw std::runtime_error{"reactor is unavailable"};
+    std::lock_guard lock{_mutex};
+    auto [it, inserted] = _fds.try_emplace(fd);
+    auto& state = it->second;
+    state._waiters[index_of(readiness)].push_back(std::move(callback));
+    _waiter_count.fetch_add(1, std::memory_order::release);
+    if (!arm(fd, state, inserted ? EPOLL_CTL_ADD : EPOLL_CTL_MOD)) {
+      // fd 无效或不支持 epoll(如普通文件)，撤销本次等待
+      state._waiters[index_of(readiness)].pop_back();
+      _waiter_count.fetch_sub(1, std::memory_order::release);
+      if (inserted) _fds.erase(it);
+      throw std::runtime_error{"failed to watch fd"};
+    }
+#else
+    (void)fd, (void)readiness, (void)callback;
+    throw std::runtime_error{"reactor is unavailable"};
+#endif
+  }
+
+  // 停止监听 fd，并把 fd 上所有等待中的回调追加到 ready(由调用方执行)，
+  // 等待者因此都会被唤醒，不会永远挂起；关闭 fd 之前需要先调用
+  void release(int fd, std::vector<std::function<void()>>& ready) {
+    std::lock_guard lock{_mutex};
+    auto it = _fds.find(fd);
+    if (it == _fds.end()) return;
+#ifdef __linux__
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    take_ready(it->second, Readiness::readable, true, ready);
+    take_ready(it->second, Readiness::writable, true, ready);
+    _fds.erase(it);
+  }
+
+  // 尝试成为 poller，同一时刻只有一个 worker 阻塞在 epoll_wait 上
+  bool try_begin_poll() {
+    return !_polling.exchange(true, std::memory_order::acq_rel);
+  }
+  void end_poll() { _polling.store(false, std::memory_order::release); }
+
+  // 等待 fd 就绪，最多等待 timeout(0 表示不等待)，
+  // 就绪的回调追加到 ready，返回是否有回调就绪(调用方需要先成为 poller)
+  bool poll(std::chrono::microseconds timeout,
+            std::vector<std::function<void()>>& ready) {
+#ifdef __linux__
+    // epoll_wait 的精度是毫秒，向上取整，poller 可以被 wake 提前唤醒
+    auto ms = timeout.count() <= 0
+                  ? 0
+                  : static_cast<int>((timeout.count() + 999) / 1000);
+    std::array<epoll_event, MAX_EVENTS> events;
+    auto n = ::epoll_wait(_epoll_fd, events.data(), MAX_EVENTS, ms);
+    if (n <= 0) return false;
+    auto before = ready.size();
+    std::lock_guard lock{_mutex};
+    for (int i = 0; i < n; ++i) {
+      auto fd = events[i].data.fd;
+      if (fd == _wake_fd) {
+        std::uint64_t value;
+        while (::read(_wake_fd, &value, sizeof(value)) > 0) {
+        }
+        continue;
+      }
+      auto it = _fds.find(fd);
+      if (it == _fds.end()) continue;
+      auto& state = it->second;
+      auto flags = events[i].events;
+      bool error = (flags & (EPOLLERR | EPOLLHUP)) != 0;
+      take_ready(state, Readiness::readable,
+                 error || (flags & (EPOLLIN | EPOLLRDHUP)) != 0, ready);
+      take_ready(state, Readiness::writable,
+                 error || (flags & EPOLLOUT) != 0, ready);
+      // 还有等待的方向时重新注册(EPOLLONESHOT 触发后需要重新注册)
+      if (interest(state) == 0) {
+        ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        _fds.erase(it);
+      } else {
+        arm(fd, state, EPOLL_CTL_MOD);
+      }
+    }
+    return ready.size() > before;
+#else
+    (void)timeout, (void)ready;
+    return false;
+#endif
+  }
+
+  // 唤醒阻塞在 epoll_wait 上的 poller
+  void wake() {
+#ifdef __linux__
+    if (_wake_fd >= 0) {
+      std::uint64_t one = 1;
+      [[maybe_unused]] auto n = ::write(_wake_fd, &one, sizeof(one));
+    }
+#endif
+  }
+
+ private:
+  // 一个 fd 上等待可读和可写的回调
+  struct FdState {
+    std::array<std::vector<std::function<void()>>, 2> _waiters{};
+  };
+
+  constexpr static inline int MAX_EVENTS = 64;
+
+  static std::size_t index_of(Readiness readiness) {
+    return static_cast<std::size_t>(readiness);
+  }
+
+  // 取出 fd 上某个方向就绪的回调(调用方持有锁)
+  void take_ready(FdState& state, Readiness readiness, bool is_ready,
+                  std::vector<std::function<void()>>& ready) {
+    auto& waiters = state._waiters[index_of(readiness)];
+    if (!is_ready || waiters.empty()) return;
+    _waiter_count.fetch_sub(waiters.size(), std::memory_order::release);
+    std::ranges::move(waiters, std::back_inserter(ready));
+    waiters.clear();
+  }
+
+#ifdef __linux__
+  // 根据等待中的方向计算 epoll 事件
+  static std::uint32_t interest(const FdState& state) {
+    std::uint32_t events = 0;
+    if (!state._waiters[index_of(Readiness::readable)].empty()) {
+      events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (!state._waiters[index_of(Readiness::writable)].empty()) {
+      events |= EPOLLOUT;
+    }
+    return events;
+  }
+
+  // 按等待中的方向注册 fd(调用方持有锁)
+  bool arm(int fd, const FdState& state, int op) {
+    epoll_event event{};
+    event.events = interest(state) | EPOLLONESHOT;
+    event.data.fd = fd;
+    return ::epoll_ctl(_epoll_fd, op, fd, &event) == 0;
+  }
+#endif
+
+ private:
+  int _epoll_fd{-1};                          // epoll 实例
+  int _wake_fd{-1};                           // 唤醒 poller 的 eventfd
+  std::mutex _mutex{};                        // 保护 _fds
+  std::unordered_map<int, FdState> _fds{};    // 等待中的 fd
+  std::atomic<std::size_t> _waiter_count{0};  // 等待中的回调数量
+  std::atomic<bool> _polling{false};          // 是否有 worker 正在驱动
+};
+
+// co_await 等待 fd 就绪，就绪后协程在 worker 上恢复执行
+class ReadinessAwaiter {
+ public:
+  ReadinessAwaiter(Reactor& reactor, int fd, Readiness readiness)
+      : _reactor(&reactor), _fd(fd), _readiness(readiness) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    try {
+      _reactor->add_waiter(_fd, _readiness, make_resume_job(handle));
+    } catch (...) {
+      // 等待没有注册成功，撤销恢复任务对任务组的计数，异常在 co_await 处抛出
+      if (t_current_task_group) t_current_task_group->decrement();
+      throw;
+    }
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  Reactor* _reactor;
+  int _fd;
+  Readiness _readiness;
+};
+}  // namespace fastexec::detail
+
+#endif
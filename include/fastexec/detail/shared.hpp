@@ -1,77 +1,453 @@
 #ifndef __FASTSTDEXEC_DETAIL_SHARED_HPP
 #define __FASTSTDEXEC_DETAIL_SHARED_HPP
 
-#include <latch>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
 #include <span>
+#include <stdexcept>
 #include <vector>
 
+#include "options.hpp"
+#include "priority.hpp"
 #include "queue.hpp"
+#include "reactor.hpp"
+#include "taskgroup.hpp"
+#include "timer.hpp"
+#include "topology.hpp"
 namespace fastexec::detail {
+template <typename Policy>
 class Worker;
-class Shared;
 
-// 线程局部存储，当前共享类指针
-static inline thread_local Shared* t_shared{nullptr};
+// 线程池中与调度策略无关的调度接口，协程唤醒等跨线程池的代码只依赖它
+class Scheduler : util::noncopyable {
+ public:
+  // 把恢复任务交回线程池：当前线程是本线程池的 worker 时放入它的本地队列，
+  // 否则放入全局队列并唤醒一个空闲 worker；线程池已关闭时抛出异常(job 不变)
+  virtual void resume(std::function<void()>& job) = 0;
+
+ protected:
+  ~Scheduler() = default;
+};
 
-class Shared : util::noncopyable {
-  friend class Worker;
+// 线程局部存储，当前线程所属线程池的调度接口，不是 worker 线程时为空
+static inline thread_local Scheduler* t_scheduler{nullptr};
+// 线程局部存储，当前线程在所属线程池中的 worker id，t_scheduler 为空时无意义
+static inline thread_local std::size_t t_worker_id{0};
+
+// worker 的窃取域，按距离由近到远排列：
+// SMT 兄弟线程、共享 L3 的 worker、同一 NUMA 节点的 worker、其他节点的 worker
+// 每个域是一个与有任务位图等宽的掩码
+struct StealDomains {
+  std::vector<std::vector<std::uint64_t>> _near{};  // 本节点内的各级域
+  std::vector<std::uint64_t> _remote{};             // 其他节点，为空表示没有
+};
+
+template <typename Policy>
+class Shared : public Scheduler {
+  friend class Worker<Policy>;
 
  public:
-  explicit Shared(std::size_t worker_count) : _stop_latch(worker_count) {
-    assert(t_shared == nullptr);
-    t_shared = this;
-    _workers.reserve(worker_count);
-    _workers.resize(worker_count);
+  // placement 为每个 worker 槽位所在的 CPU，其大小即 worker 数量的上限，
+  // 运行中的 worker 数量由 set_worker_limit 调整
+  // pinned 为 worker 是否绑定到 placement 给出的 CPU，没有绑定时不使用拓扑
+  // global_queue_capacity 为每个全局队列的容量(0 表示不限制)，
+  // 满时新提交的任务按 overflow_policy 处理
+  // scaling 为 worker 数量的动态伸缩策略，worker 开始运行时是活跃的
+  Shared(const Topology& topology, std::span<const CpuInfo> placement,
+         bool pinned, std::size_t global_queue_capacity = 0,
+         OverflowPolicy overflow_policy = OverflowPolicy::block,
+         ScalingPolicy scaling = {})
+      : _workers(placement.size()),
+        _worker_limit(placement.size()),
+        _global_queue_capacity(global_queue_capacity),
+        _overflow_policy(overflow_policy),
+        _scaling(scaling),
+        _idle_workers(placement.size()),
+        _work_bitmap((placement.size() + 63) / 64) {
+    init_topology(topology, placement, pinned);
+    _timer_wheels.resize(placement.size());
+    for (auto& wheel : _timer_wheels) {
+      wheel = std::make_unique<TimerWheel>();
+    }
+    _inboxes.resize(placement.size());
+    for (auto& inbox : _inboxes) {
+      inbox = std::make_unique<MpscQueue>();
+    }
+    // 伸缩时至少保留一个活跃 worker 驱动 reactor 和全局队列
+    if (_scaling.min_active != 0) {
+      _scaling.min_active =
+          std::clamp<std::size_t>(_scaling.min_active, 1, placement.size());
+    }
   }
 
-  ~Shared() { t_shared = nullptr; }
+  ~Shared() = default;
 
  public:
-  // 注册 worker
-  void register_worker(int worker_id, Worker* worker) {
-    _workers[worker_id] = worker;
+  // 注册 worker：每个槽位的 worker 第一次启动时注册，之后一直有效
+  // (worker 对象属于线程池，退役后保留，槽位重新启动时复用)
+  void register_worker(std::size_t worker_id, Worker<Policy>* worker) {
+    _workers[worker_id].store(worker, std::memory_order::release);
   }
 
-  // 获取所有注册的 worker
+  // 获取槽位上注册的 worker，还没有启动过时返回空
   [[nodiscard]]
-  std::span<Worker*> get_workers() {
-    return _workers;
+  Worker<Policy>* get_worker(std::size_t worker_id) const {
+    return _workers[worker_id].load(std::memory_order::acquire);
   }
 
-  // 获取注册的 worker 总数
+  // worker 槽位总数(worker 数量的上限)
   [[nodiscard]]
   std::size_t total_worker_count() const {
     return _workers.size();
   }
 
-  // 全局队列关闭
-  void global_queue_close() { _global_queue.close(); }
+  // 应当运行的 worker 数量，编号不小于它的 worker 退役
+  [[nodiscard]]
+  std::size_t worker_limit() const {
+    return _worker_limit.load(std::memory_order::acquire);
+  }
+
+  void set_worker_limit(std::size_t limit) {
+    _worker_limit.store(limit, std::memory_order::release);
+  }
+
+  // 获取 worker 所在的 NUMA 节点下标
+  [[nodiscard]]
+  std::size_t worker_node(std::size_t worker_id) const {
+    return _worker_nodes[worker_id];
+  }
+
+  // 获取 worker 的窃取域
+  [[nodiscard]]
+  const StealDomains& steal_domains(std::size_t worker_id) const {
+    return _steal_domains[worker_id];
+  }
+
+  // 全局队列关闭，并唤醒所有 worker(包括停用的)处理剩余任务后退出
+  // worker 只根据第一个队列判断是否已关闭，所以倒序关闭、最后关闭它：
+  // worker 看到关闭时所有队列都已经拒绝放入，之后不会再有任务进入全局队列
+  void global_queue_close() {
+    for (auto& queue : _global_queues | std::views::reverse) {
+      queue->close();
+    }
+    wake_all_workers();
+  }
+
+  // 判断全局队列是否已关闭
+  [[nodiscard]]
+  bool global_queue_closed() const {
+    return _global_queues.front()->closed();
+  }
+
+  // 放弃排队中的任务：之后 worker 取到的任务都被丢弃，并唤醒所有 worker
+  void abort_queued_tasks() {
+    _aborting.store(true, std::memory_order::release);
+    wake_all_workers();
+  }
+
+  // 是否在放弃排队中的任务
+  [[nodiscard]]
+  bool aborting() const {
+    return _aborting.load(std::memory_order::relaxed);
+  }
+
+  // 线程池重新启动：重新打开全局队列，不再丢弃任务
+  // 需要在所有 worker 退出后调用
+  void global_queue_reopen() {
+    _aborting.store(false, std::memory_order::release);
+    for (auto& queue : _global_queues) {
+      queue->reopen();
+    }
+  }
 
-  // 获取全局任务队列中的下一个任务
-  std::optional<std::function<void()>> get_next_global_task() {
-    return _global_queue.try_pop();
+  // 丢弃所有时间轮中未到期的定时器，所有 worker 退出后调用
+  void clear_timers() {
+    for (auto& wheel : _timer_wheels) {
+      wheel->clear();
+    }
   }
 
-  // 获取全局任务队列中的多个任务
+  // 按优先级从高到低获取指定节点全局任务队列中的下一个任务
+  std::optional<std::function<void()>> get_next_global_task(std::size_t node) {
+    for (std::size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+      auto& queue = get_global_queue(node, level);
+      if (queue.empty()) continue;
+      auto task = queue.try_pop();
+      if (task.has_value()) {
+        return task;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // 获取其他节点全局任务队列中的下一个任务，从相邻节点开始依次尝试
+  std::optional<std::function<void()>> get_next_remote_global_task(
+      std::size_t node) {
+    auto node_num = node_count();
+    for (std::size_t i = 1; i < node_num; ++i) {
+      auto task = get_next_global_task((node + i) % node_num);
+      if (task.has_value()) {
+        return task;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // 获取指定节点、指定优先级全局任务队列中的多个任务
   std::optional<std::vector<std::function<void()>>> get_batch_global_tasks(
-      std::size_t batch_size) {
-    return _global_queue.try_pop_batch(batch_size);
+      std::size_t node, std::size_t level, std::size_t batch_size) {
+    return get_global_queue(node, level).try_pop_batch(batch_size);
+  }
+
+  // 判断所有全局任务队列(包括全局截止时间队列)是否都为空
+  bool is_global_queue_empty() {
+    for (auto& queue : _global_queues) {
+      if (!queue->empty()) {
+        return false;
+      }
+    }
+    return _global_deadline_queue.empty();
+  }
+
+  // 所有全局队列中排队的任务总数，不加锁读取，只是一个近似值
+  [[nodiscard]]
+  std::size_t global_queue_size() const {
+    std::size_t size = 0;
+    for (auto& queue : _global_queues) {
+      size += queue->size();
+    }
+    return size;
   }
 
-  // 判断全局任务队列是否为空
-  bool is_global_queue_empty() { return _global_queue.empty(); }
+  // 判断指定节点、指定优先级的全局任务队列是否为空
+  bool is_global_queue_empty(std::size_t node, std::size_t level) {
+    return get_global_queue(node, level).empty();
+  }
 
-  // 将任务添加到全局任务队列的末尾
-  void push_back_task_to_global(std::function<void()> task) {
-    _global_queue.push_back(std::move(task));
+  // 将任务添加到调用线程所在节点、指定优先级全局任务队列的末尾
+  void push_back_task_to_global(std::function<void()> task,
+                                Priority priority = Priority::normal) {
+    get_global_queue(caller_node(), level_of(priority))
+        .push_back(std::move(task));
   }
-  // 将多个任务添加到全局任务队列的末尾
+  // 将多个任务添加到调用线程所在节点全局任务队列的末尾
   void push_back_batch_task_to_global(
       std::vector<std::function<void()>> tasks) {
-    _global_queue.push_back_batch(tasks);
+    get_global_queue(caller_node(), level_of(Priority::normal))
+        .push_back_batch(tasks);
+  }
+  // 提交新任务到调用线程所在节点、指定优先级的全局任务队列，
+  // 队列已满时按溢出策略处理；may_block 为 false 时 block 退化为 caller_runs
+  void admit_task_to_global(std::function<void()> task, Priority priority,
+                            bool may_block) {
+    auto& queue = get_global_queue(caller_node(), level_of(priority));
+    if (queue.try_push_back(task)) return;
+    handle_overflow(queue, std::span{&task, 1}, may_block);
+  }
+  // 提交多个新任务到调用线程所在节点的全局任务队列，放不下的按溢出策略处理
+  void admit_batch_task_to_global(std::span<std::function<void()>> tasks,
+                                  bool may_block) {
+    admit_batch_task(get_global_queue(caller_node(), level_of(Priority::normal)),
+                     tasks, may_block);
+  }
+  // 提交多个新任务到指定的全局任务队列，放不下的按溢出策略处理
+  void admit_batch_task(GlobalQueue& queue,
+                        std::span<std::function<void()>> tasks,
+                        bool may_block) {
+    auto n = queue.try_push_back_batch(tasks);
+    if (n < tasks.size()) {
+      handle_overflow(queue, tasks.subspan(n), may_block);
+    }
+  }
+
+  // 按溢出策略处理 queue 放不下的新任务
+  void handle_overflow(GlobalQueue& queue,
+                       std::span<std::function<void()>> tasks,
+                       bool may_block) {
+    switch (_overflow_policy) {
+      case OverflowPolicy::block:
+        if (may_block) {
+          for (auto& task : tasks) {
+            _overflow_blocked.fetch_add(1, std::memory_order::relaxed);
+            queue.push_back_wait(std::move(task));
+          }
+          return;
+        }
+        // worker 线程等待空间可能造成所有 worker 互相等待，改为直接执行
+        [[fallthrough]];
+      case OverflowPolicy::caller_runs:
+        for (auto& task : tasks) {
+          _overflow_caller_runs.fetch_add(1, std::memory_order::relaxed);
+          task();
+        }
+        return;
+      case OverflowPolicy::reject:
+        // 丢弃被拒绝的任务，让其任务组计数归还、future 得到异常
+        for (auto& task : tasks) {
+          _overflow_rejected.fetch_add(1, std::memory_order::relaxed);
+          discard_task(task);
+        }
+        throw std::runtime_error{"queue is full"};
+      case OverflowPolicy::drop_oldest:
+        for (auto& task : tasks) {
+          if (auto oldest = queue.replace_oldest(std::move(task))) {
+            _overflow_dropped.fetch_add(1, std::memory_order::relaxed);
+            discard_task(*oldest);
+          }
+        }
+        return;
+    }
+  }
+
+  // 各溢出策略生效的次数
+  [[nodiscard]]
+  OverflowStats overflow_stats() const {
+    return OverflowStats{
+        _overflow_blocked.load(std::memory_order::relaxed),
+        _overflow_rejected.load(std::memory_order::relaxed),
+        _overflow_caller_runs.load(std::memory_order::relaxed),
+        _overflow_dropped.load(std::memory_order::relaxed),
+    };
+  }
+
+  // 获取指定节点、指定优先级的全局任务队列
+  GlobalQueue& get_global_queue(std::size_t node, std::size_t level) {
+    return *_global_queues[node * PRIORITY_LEVELS + level];
+  }
+
+  // 将截止时间任务添加到全局截止时间队列
+  void push_deadline_task_to_global(deadline_clock::time_point deadline,
+                                    std::function<void()> task) {
+    if (global_queue_closed()) throw std::runtime_error{"queue is closed"};
+    _global_deadline_queue.push(deadline, std::move(task));
+    increment_deadline_task_count();
+  }
+
+  // 获取全局截止时间队列
+  DeadlineQueue& get_global_deadline_queue() { return _global_deadline_queue; }
+
+  // 是否还有未执行的截止时间任务，没有时 worker 跳过截止时间队列的检查
+  [[nodiscard]]
+  bool has_deadline_tasks() const {
+    return _deadline_task_count.load(std::memory_order::acquire) > 0;
+  }
+  void increment_deadline_task_count() {
+    _deadline_task_count.fetch_add(1, std::memory_order::release);
   }
-  // 获取全局任务队列
-  GlobalQueue& get_global_queue() { return _global_queue; }
+  void decrement_deadline_task_count() {
+    _deadline_task_count.fetch_sub(1, std::memory_order::release);
+  }
+
+  // 记录一次错过截止时间(任务完成时已经超过截止时间)
+  void record_missed_deadline() {
+    _missed_deadlines.fetch_add(1, std::memory_order::relaxed);
+  }
+
+  // 错过截止时间的任务数量
+  [[nodiscard]]
+  std::size_t missed_deadlines() const {
+    return _missed_deadlines.load(std::memory_order::relaxed);
+  }
+
+  // 获取 worker 的定时器时间轮
+  TimerWheel& timer_wheel(std::size_t worker_id) {
+    return *_timer_wheels[worker_id];
+  }
+
+  // 获取 worker 的收件箱
+  MpscQueue& inbox(std::size_t worker_id) { return *_inboxes[worker_id]; }
+
+  // 把任务放入指定 worker 的收件箱并唤醒它(定义在 worker.hpp)
+  void push_back_task_to_inbox(std::size_t worker_id,
+                               std::function<void()> task);
+
+  // 休眠的 worker 把自己登记为空闲
+  void push_idle_worker(std::size_t worker_id) {
+    _idle_workers.push(worker_id);
+  }
+
+  // 把外部线程提交的任务直接交给一个休眠的 worker(定义在 worker.hpp)
+  bool try_handoff(std::function<void()>& task, Priority priority);
+
+  // 为外部线程插入的定时器在运行中的 worker 之间轮流选择一个时间轮
+  std::size_t next_timer_wheel() {
+    return _timer_index.fetch_add(1, std::memory_order::relaxed) %
+           worker_limit();
+  }
+
+  // 获取线程池的 reactor
+  Reactor& reactor() { return _reactor; }
+
+  // NUMA 节点数量(每个节点有一组全局队列)
+  [[nodiscard]]
+  std::size_t node_count() const {
+    return _global_queues.size() / PRIORITY_LEVELS;
+  }
+
+  // 唤醒最多 count 个空闲 worker 来消费新提交的任务(定义在 worker.hpp)
+  void notify_workers(std::size_t count);
+
+  // 唤醒所有 worker，包括停用的(定义在 worker.hpp)
+  void wake_all_workers();
+
+  // 是否开启了 worker 数量动态伸缩
+  [[nodiscard]]
+  bool scaling_enabled() const {
+    return _scaling.min_active != 0;
+  }
+
+  // 动态伸缩策略
+  [[nodiscard]]
+  const ScalingPolicy& scaling() const {
+    return _scaling;
+  }
+
+  // 活跃的 worker 数量
+  [[nodiscard]]
+  std::size_t active_worker_count() const {
+    return _active_count.load(std::memory_order::acquire);
+  }
+
+  // 活跃 worker 数量多于 min_active 时减 1 并返回 true，worker 随后停用
+  bool try_deactivate() {
+    auto count = _active_count.load(std::memory_order::relaxed);
+    while (count > _scaling.min_active) {
+      if (_active_count.compare_exchange_weak(count, count - 1,
+                                              std::memory_order::acq_rel,
+                                              std::memory_order::relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // worker 开始运行或停用后被唤醒时计入活跃数量
+  void reactivate() { _active_count.fetch_add(1, std::memory_order::acq_rel); }
+
+  // worker 退役或退出时不再计入活跃数量
+  void mark_inactive() {
+    _active_count.fetch_sub(1, std::memory_order::acq_rel);
+  }
+
+  // 还有停用的 worker，并且全局队列和 extra(调用者本地队列中)的任务数
+  // 超过了活跃 worker 能及时处理的数量
+  [[nodiscard]]
+  bool is_backlogged(std::size_t extra = 0) const {
+    auto active = active_worker_count();
+    return scaling_enabled() && active < worker_limit() &&
+           global_queue_size() + extra > active * _scaling.backlog_per_worker;
+  }
+
+  // 唤醒一个停用的 worker，返回是否唤醒了(定义在 worker.hpp)
+  bool activate_worker();
+
+  // 把恢复任务交回线程池(定义在 worker.hpp)
+  void resume(std::function<void()>& job) override;
 
   // 增加窃取任务的 worker 数量
   void increment_steal_worker_count() {
@@ -82,17 +458,200 @@ class Shared : util::noncopyable {
     _steal_worker_count.fetch_sub(1, std::memory_order::release);
   }
 
-  // 判断是否可以窃取任务
+  // 在位图中标记 worker 的本地队列有任务(只由 worker 自己调用)
+  void mark_worker_has_task(std::size_t worker_id) {
+    auto& word = _work_bitmap[worker_id / 64];
+    auto bit = std::uint64_t{1} << (worker_id % 64);
+    // 先读后写，位已经置上时不产生写操作，避免无谓的缓存行争用
+    if ((word.load(std::memory_order::relaxed) & bit) == 0) {
+      word.fetch_or(bit, std::memory_order::release);
+    }
+  }
+
+  // 在位图中清除 worker 的有任务标记(只由 worker 自己调用)
+  void clear_worker_has_task(std::size_t worker_id) {
+    auto& word = _work_bitmap[worker_id / 64];
+    auto bit = std::uint64_t{1} << (worker_id % 64);
+    if ((word.load(std::memory_order::relaxed) & bit) != 0) {
+      word.fetch_and(~bit, std::memory_order::release);
+    }
+  }
+
+  // 从 start 开始循环查找下一个本地队列有任务的 worker，跳过 self
+  // 只读取位图(每 64 个 worker 一个字)，不触碰各个 worker 的队列
+  // domain 不为空时只在该窃取域内查找
+  std::optional<std::size_t> next_busy_worker(
+      std::size_t start, std::size_t self,
+      std::span<const std::uint64_t> domain = {}) const {
+    auto words = _work_bitmap.size();
+    auto start_word = start / 64;
+    auto start_bit = start % 64;
+    // 多扫描一次起始字，用于回绕到 start 之前的位
+    for (std::size_t k = 0; k <= words; ++k) {
+      auto w = (start_word + k) % words;
+      auto bits = _work_bitmap[w].load(std::memory_order::acquire);
+      if (k == 0) {
+        bits &= ~std::uint64_t{0} << start_bit;
+      } else if (k == words) {
+        bits &= ~(~std::uint64_t{0} << start_bit);
+      }
+      if (!domain.empty()) {
+        bits &= domain[w];
+      }
+      if (w == self / 64) {
+        bits &= ~(std::uint64_t{1} << (self % 64));
+      }
+      if (bits != 0) {
+        return w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+      }
+    }
+    return std::nullopt;
+  }
+
+  // 判断是否可以窃取任务，同时窃取的 worker 数受调度策略限制，
+  // 但至少允许一个，worker 很少时其他 worker 留下的任务仍然有人取
   bool can_steal_task() const {
     return _steal_worker_count.load(std::memory_order::acquire) <
-           (_workers.size() / 2);
+           std::max<std::size_t>(
+               1, worker_limit() / Policy::steal_throttle_divisor);
   }
 
  private:
-  std::vector<Worker*> _workers{};                  // 所有注册的 worker
-  GlobalQueue _global_queue{};                      // 全局任务队列
+  // 根据每个 worker 所在的 CPU 计算其 NUMA 节点和窃取域，
+  // 并为每个有 worker 的节点创建一组全局队列
+  // worker 没有绑定 CPU 时由内核自由调度，placement 不是它们实际运行的位置：
+  // 只有一组全局队列，其他所有 worker 组成一个窃取域
+  void init_topology(const Topology& topology,
+                     std::span<const CpuInfo> placement, bool pinned) {
+    auto cpus = topology.cpus();
+    auto worker_count = placement.size();
+    auto words = _work_bitmap.size();
+    if (!pinned) {
+      _worker_nodes.assign(worker_count, 0);
+      _global_queues.resize(PRIORITY_LEVELS);
+      for (auto& queue : _global_queues) {
+        queue = std::make_unique<GlobalQueue>(_global_queue_capacity);
+      }
+      _steal_domains.resize(worker_count);
+      if (worker_count > 1) {
+        for (std::size_t i = 0; i < worker_count; ++i) {
+          std::vector<std::uint64_t> domain(words, 0);
+          for (std::size_t j = 0; j < worker_count; ++j) {
+            if (j != i) domain[j / 64] |= std::uint64_t{1} << (j % 64);
+          }
+          _steal_domains[i]._near.push_back(std::move(domain));
+        }
+      }
+      return;
+    }
+    // 只为有 worker 的节点创建全局队列，节点下标按出现顺序重新编号，
+    // 没有 worker 的节点上的外部线程轮流映射到这些节点
+    constexpr auto NO_NODE = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> node_map(
+        std::max<std::size_t>(1, topology.node_count()), NO_NODE);
+    std::size_t node_num = 0;
+    _worker_nodes.resize(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+      auto& node = node_map[topology.node_index(placement[i].node)];
+      if (node == NO_NODE) {
+        node = node_num++;
+      }
+      _worker_nodes[i] = node;
+    }
+    node_num = std::max<std::size_t>(1, node_num);
+    for (std::size_t i = 0, next = 0; i < node_map.size(); ++i) {
+      if (node_map[i] == NO_NODE) {
+        node_map[i] = next++ % node_num;
+      }
+    }
+
+    _global_queues.resize(node_num * PRIORITY_LEVELS);
+    for (auto& queue : _global_queues) {
+      queue = std::make_unique<GlobalQueue>(_global_queue_capacity);
+    }
+    int max_cpu = 0;
+    for (auto& c : cpus) {
+      max_cpu = std::max(max_cpu, c.cpu);
+    }
+    _cpu_nodes.assign(static_cast<std::size_t>(max_cpu) + 1, 0);
+    for (auto& c : cpus) {
+      _cpu_nodes[static_cast<std::size_t>(c.cpu)] =
+          node_map[topology.node_index(c.node)];
+    }
+
+    _steal_domains.resize(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+      // 0: SMT 兄弟, 1: 共享 L3, 2: 同一节点, 3: 其他节点
+      std::vector<std::vector<std::uint64_t>> levels(
+          4, std::vector<std::uint64_t>(words, 0));
+      std::vector<bool> used(4, false);
+      for (std::size_t j = 0; j < worker_count; ++j) {
+        if (j == i) continue;
+        auto& a = placement[i];
+        auto& b = placement[j];
+        std::size_t level = a.core == b.core ? 0
+                            : a.l3 == b.l3   ? 1
+                            : a.node == b.node ? 2
+                                               : 3;
+        levels[level][j / 64] |= std::uint64_t{1} << (j % 64);
+        used[level] = true;
+      }
+      for (std::size_t level = 0; level < 3; ++level) {
+        if (used[level]) {
+          _steal_domains[i]._near.push_back(std::move(levels[level]));
+        }
+      }
+      if (used[3]) {
+        _steal_domains[i]._remote = std::move(levels[3]);
+      }
+    }
+  }
+
+  // 调用线程所在的 NUMA 节点下标，用于外部线程提交任务
+  // (worker 没有绑定 CPU 时只有一个节点，总是 0)
+  std::size_t caller_node() const {
+#ifdef __linux__
+    auto cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<std::size_t>(cpu) < _cpu_nodes.size()) {
+      return _cpu_nodes[static_cast<std::size_t>(cpu)];
+    }
+#endif
+    return 0;
+  }
+
+ private:
+  // 直接交给空闲 worker 时最多尝试的次数(弹出的 worker 可能已经醒来)
+  constexpr static inline std::size_t HANDOFF_ATTEMPTS = 4;
+
+  std::vector<std::atomic<Worker<Policy>*>> _workers;  // 各槽位注册的 worker
+  std::atomic<std::size_t> _worker_limit;  // 应当运行的 worker 数量
+  // 全局队列，每个节点每个优先级一个，下标为 节点 * 级数 + 优先级
+  std::vector<std::unique_ptr<GlobalQueue>> _global_queues{};
+  std::size_t _global_queue_capacity;  // 每个全局队列的容量，0 表示不限制
+  OverflowPolicy _overflow_policy;        // 全局队列满时的溢出策略
+  std::atomic<bool> _aborting{false};     // 是否在放弃排队中的任务
+  ScalingPolicy _scaling;                 // worker 数量动态伸缩策略
+  std::atomic<std::size_t> _active_count{0};  // 活跃的 worker 数量
+  std::atomic<std::uint64_t> _overflow_blocked{0};      // 等待空间的次数
+  std::atomic<std::uint64_t> _overflow_rejected{0};     // 拒绝的任务数
+  std::atomic<std::uint64_t> _overflow_caller_runs{0};  // 直接执行的任务数
+  std::atomic<std::uint64_t> _overflow_dropped{0};      // 丢弃的任务数
+  DeadlineQueue _global_deadline_queue{};  // 外部线程提交的截止时间任务
+  std::atomic<std::size_t> _deadline_task_count{0};  // 未执行的截止时间任务数
+  std::atomic<std::size_t> _missed_deadlines{0};     // 错过截止时间的任务数
+  // 定时器时间轮，每个 worker 一个，由该 worker 驱动
+  std::vector<std::unique_ptr<TimerWheel>> _timer_wheels{};
+  std::atomic<std::size_t> _timer_index{0};  // 外部线程插入定时器的轮询索引
+  // 收件箱，每个 worker 一个，放入的任务只由该 worker 执行
+  std::vector<std::unique_ptr<MpscQueue>> _inboxes{};
+  IdleStack _idle_workers;  // 休眠中的 worker，外部线程提交时直接交给它们
+  Reactor _reactor{};  // fd 就绪等待，由空闲的 worker 驱动
+  std::vector<std::size_t> _worker_nodes{};    // 每个 worker 所在节点下标
+  std::vector<std::size_t> _cpu_nodes{};       // 每个 CPU 所在节点下标
+  std::vector<StealDomains> _steal_domains{};  // 每个 worker 的窃取域
   std::atomic<std::size_t> _steal_worker_count{0};  // 窃取任务的 worker 数量
-  std::latch _stop_latch;  // 等待所有 Worker 线程完成任务
+  std::atomic<std::size_t> _notify_index{0};        // 唤醒 worker 的轮询索引
+  std::vector<std::atomic<std::uint64_t>> _work_bitmap;  // 本地队列有任务位图
 };
 }  // namespace fastexec::detail
 
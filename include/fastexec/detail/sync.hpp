@@ -0,0 +1,259 @@
+#ifndef __FASTSTDEXEC_DETAIL_SYNC_HPP
+#define __FASTSTDEXEC_DETAIL_SYNC_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "util.hpp"
+#include "waiter.hpp"
+namespace fastexec::detail {
+// 异步信号量：没有许可时挂起协程而不是阻塞 worker 线程
+// 快速路径只有一次 CAS；有等待者时新的获取者不插队，直接排到等待队列末尾，
+// 释放时把许可直接交给队首的等待者，再把它的协程交回线程池恢复
+// 等待者计数与快速路径之间用 seq_cst 栅栏配合，不会丢失唤醒
+class AsyncSemaphore : util::noncopyable {
+ public:
+  // co_await semaphore.acquire()
+  class Awaiter {
+   public:
+    explicit Awaiter(AsyncSemaphore& semaphore) : _semaphore(&semaphore) {}
+
+    bool await_ready() {
+      return _semaphore->try_acquire() && !(_yield = budget_exhausted());
+    }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      if (_yield) return yield_to_scheduler(handle);
+      return _semaphore->park(_parked, handle);
+    }
+    void await_resume() const noexcept {}
+
+   private:
+    AsyncSemaphore* _semaphore;
+    Parked _parked{};
+    bool _yield{false};  // 已经获取但预算耗尽，挂起让出 worker
+  };
+
+ public:
+  explicit AsyncSemaphore(std::size_t permits) : _permits(permits) {}
+
+ public:
+  // 在协程中获取一个许可，没有许可时挂起
+  [[nodiscard]]
+  Awaiter acquire() {
+    return Awaiter{*this};
+  }
+
+  // 不挂起地获取一个许可，有等待者或没有许可时返回 false
+  bool try_acquire() {
+    if (_waiter_count.load(std::memory_order::acquire) != 0) return false;
+    return take_permit();
+  }
+
+  // 释放 n 个许可，有等待者时按到达顺序交给它们
+  void release(std::size_t n = 1) {
+    _permits.fetch_add(n, std::memory_order::release);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (_waiter_count.load(std::memory_order::relaxed) == 0) return;
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      while (!_waiters.empty() && take_permit()) {
+        ready.push_back(_waiters.front());
+        _waiters.pop_front();
+        _waiter_count.fetch_sub(1, std::memory_order::release);
+      }
+    }
+    for (auto parked : ready) {
+      parked->wake();
+    }
+  }
+
+  // 当前可用的许可数量
+  [[nodiscard]]
+  std::size_t available() const {
+    return _permits.load(std::memory_order::acquire);
+  }
+
+ private:
+  bool take_permit() {
+    auto permits = _permits.load(std::memory_order::relaxed);
+    while (permits > 0) {
+      if (_permits.compare_exchange_weak(permits, permits - 1,
+                                         std::memory_order::acquire,
+                                         std::memory_order::relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 加锁后先增加等待者计数再重试一次，仍没有许可时排队挂起，返回是否挂起
+  // 队列中已有等待者时不重试，保证先到先得
+  bool park(Parked& parked, std::coroutine_handle<> handle) {
+    std::lock_guard lock{_mutex};
+    _waiter_count.fetch_add(1, std::memory_order::seq_cst);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (_waiters.empty() && take_permit()) {
+      _waiter_count.fetch_sub(1, std::memory_order::release);
+      return false;
+    }
+    parked = Parked{handle};
+    _waiters.push_back(&parked);
+    return true;
+  }
+
+ private:
+  std::atomic<std::size_t> _permits;          // 可用的许可数量
+  std::atomic<std::size_t> _waiter_count{0};  // 等待者数量(含正在排队的)
+  std::mutex _mutex{};                        // 保护等待队列
+  std::deque<Parked*> _waiters{};             // 等待许可的协程
+};
+
+class AsyncMutex;
+
+// 异步互斥锁的 RAII 守卫，析构时解锁
+class AsyncLockGuard {
+ public:
+  explicit AsyncLockGuard(AsyncMutex& mutex) : _mutex(&mutex) {}
+  AsyncLockGuard(AsyncLockGuard&& other) noexcept
+      : _mutex(std::exchange(other._mutex, nullptr)) {}
+  AsyncLockGuard& operator=(AsyncLockGuard&& other) noexcept {
+    if (this != &other) {
+      unlock();
+      _mutex = std::exchange(other._mutex, nullptr);
+    }
+    return *this;
+  }
+  ~AsyncLockGuard() { unlock(); }
+
+ public:
+  // 提前解锁
+  void unlock();
+
+ private:
+  AsyncMutex* _mutex;
+};
+
+// 异步互斥锁：锁被占用时挂起协程，不阻塞 worker 线程
+// 解锁时直接把锁交给队首的等待者(先到先得)，竞争只占用等待队列的位置
+// 不可重入；持有锁期间可以 co_await 其他操作，锁可以在另一个 worker 上释放
+class AsyncMutex : util::noncopyable {
+ public:
+  // co_await mutex.scoped_lock()，返回守卫
+  class ScopedAwaiter : public AsyncSemaphore::Awaiter {
+   public:
+    explicit ScopedAwaiter(AsyncMutex& mutex)
+        : AsyncSemaphore::Awaiter(mutex._semaphore), _mutex(&mutex) {}
+
+    AsyncLockGuard await_resume() const noexcept {
+      return AsyncLockGuard{*_mutex};
+    }
+
+   private:
+    AsyncMutex* _mutex;
+  };
+
+ public:
+  AsyncMutex() = default;
+
+ public:
+  // 在协程中加锁，之后需要调用 unlock
+  [[nodiscard]]
+  AsyncSemaphore::Awaiter lock() {
+    return _semaphore.acquire();
+  }
+
+  // 在协程中加锁，返回析构时解锁的守卫
+  [[nodiscard]]
+  ScopedAwaiter scoped_lock() {
+    return ScopedAwaiter{*this};
+  }
+
+  // 不挂起地尝试加锁
+  bool try_lock() { return _semaphore.try_acquire(); }
+
+  // 解锁，有等待者时把锁交给队首的等待者
+  void unlock() { _semaphore.release(); }
+
+ private:
+  AsyncSemaphore _semaphore{1};  // 只有一个许可的信号量
+};
+
+inline void AsyncLockGuard::unlock() {
+  if (auto mutex = std::exchange(_mutex, nullptr)) {
+    mutex->unlock();
+  }
+}
+
+// 异步闩：计数减到 0 时唤醒所有等待的协程，只能使用一次
+class AsyncLatch : util::noncopyable {
+ public:
+  // co_await latch.wait()
+  class Awaiter {
+   public:
+    explicit Awaiter(AsyncLatch& latch) : _latch(&latch) {}
+
+    bool await_ready() const noexcept { return _latch->try_wait(); }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard lock{_latch->_mutex};
+      if (_latch->try_wait()) return false;
+      _parked = Parked{handle};
+      _latch->_waiters.push_back(&_parked);
+      return true;
+    }
+    void await_resume() const noexcept {}
+
+   private:
+    AsyncLatch* _latch;
+    Parked _parked{};
+  };
+
+ public:
+  explicit AsyncLatch(std::size_t count) : _count(count) {}
+
+ public:
+  // 计数减 n，减到 0 时唤醒所有等待者
+  void count_down(std::size_t n = 1) {
+    if (_count.fetch_sub(n, std::memory_order::acq_rel) != n) return;
+    std::vector<Parked*> ready;
+    {
+      std::lock_guard lock{_mutex};
+      ready.swap(_waiters);
+    }
+    for (auto parked : ready) {
+      parked->wake();
+    }
+  }
+
+  // 计数是否已经减到 0
+  [[nodiscard]]
+  bool try_wait() const {
+    return _count.load(std::memory_order::acquire) == 0;
+  }
+
+  // 在协程中等待计数减到 0
+  [[nodiscard]]
+  Awaiter wait() {
+    return Awaiter{*this};
+  }
+
+  // 计数减 1 并等待计数减到 0
+  [[nodiscard]]
+  Awaiter arrive_and_wait() {
+    count_down();
+    return Awaiter{*this};
+  }
+
+ private:
+  std::atomic<std::size_t> _count;  // 剩余计数
+  std::mutex _mutex{};              // 保护等待列表
+  std::vector<Parked*> _waiters{};  // 等待计数归零的协程
+};
+}  // namespace fastexec::detail
+
+#endif
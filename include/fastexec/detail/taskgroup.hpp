@@ -2,6 +2,9 @@
 #define __FASTSTDEXEC_DETAIL_TASK_GROUP_HPP
 
 #include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 
 #include "fastlog/fastlog.hpp"
 namespace fastexec::detail {
@@ -17,8 +20,10 @@ struct TaskGroup {
   // 正在运行（或排队）的任务数量
   std::atomic<size_t> running_count{0};
 
-  // 增加计数：表示有一个新任务加入了该组
-  void increment() { running_count.fetch_add(1, std::memory_order_relaxed); }
+  // 增加计数：表示有 n 个新任务加入了该组(默认为 1)
+  void increment(size_t n = 1) {
+    running_count.fetch_add(n, std::memory_order_relaxed);
+  }
 
   // 减少计数：表示该组的一个任务已完成
   void decrement() {
@@ -40,6 +45,52 @@ struct TaskGroup {
   }
 };
 
+// 线程局部存储，当前任务所属的任务组指针
+static inline thread_local std::shared_ptr<TaskGroup> t_current_task_group{
+    nullptr};
+
+// 线程局部存储，为 true 时表示正在丢弃任务(溢出策略 drop_oldest/reject)
+// make_job 包装的任务检查到后不执行用户函数，future 得到异常，任务组计数照常减一
+static inline thread_local bool t_discard_task{false};
+
+// 协作式调度预算：worker 执行每个任务前重置为 TASK_BUDGET，
+// 通道、异步锁等可等待对象每次不挂起地完成操作消耗一个单位，
+// 耗尽后协程即使不需要等待也让出 worker，避免一个任务长期占用 worker
+inline constexpr std::uint32_t TASK_BUDGET = 128;
+static inline thread_local std::uint32_t t_task_budget{TASK_BUDGET};
+
+// 这是一个 RAII 辅助类，用于在任务执行期间临时设置 TLS
+struct ContextGuard {
+  std::shared_ptr<TaskGroup> _group;
+  std::shared_ptr<TaskGroup> _prev_group;
+  explicit ContextGuard(std::shared_ptr<TaskGroup> g) : _group(std::move(g)) {
+    // 保存之前的上下文（虽然通常 Worker 线程之前是空的，但为了健壮性）
+    _prev_group = t_current_task_group;
+
+    // 设置当前任务的上下文
+    t_current_task_group = _group;
+  }
+  ~ContextGuard() {
+    // 恢复之前的上下文
+    t_current_task_group = _prev_group;
+
+    // 任务结束，计数器 -1
+    if (_group) _group->decrement();
+  }
+};
+
+// 丢弃任务：以丢弃模式执行它
+// 只有 make_job 包装的任务会被真正丢弃，协程恢复等内部任务照常执行
+inline void discard_task(std::function<void()>& task) {
+  t_discard_task = true;
+  try {
+    task();
+  } catch (...) {
+    t_discard_task = false;
+    throw;
+  }
+  t_discard_task = false;
+}
 }  // namespace fastexec::detail
 
 #endif
\ No newline at end of file
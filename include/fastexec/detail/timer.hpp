@@ -0,0 +1,348 @@
+#ifndef __FASTSTDEXEC_DETAIL_TIMER_HPP
+#define __FASTSTDEXEC_DETAIL_TIMER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "priority.hpp"
+#include "util.hpp"
+namespace fastexec::detail {
+class TimerWheel;
+
+// 定时器：挂在时间轮某个槽位的双向链表上
+// 链接在时间轮上时通过 _self 持有自己，取消或到期时解除链接并释放
+// 周期定时器到期后不在时间轮上，回调执行完后才重新插入，
+// 回调比周期慢时跳过重叠的到期，同一个回调不会在两个 worker 上同时执行
+struct TimerEntry : std::enable_shared_from_this<TimerEntry> {
+  std::function<void()> _callback{};         // 到期时执行的回调
+  std::uint64_t _expires{0};                 // 到期的 tick
+  std::uint64_t _period{0};                  // 周期(tick)，0 表示只执行一次
+  TimerEntry* _prev{nullptr};                // 槽位链表的前驱
+  TimerEntry* _next{nullptr};                // 槽位链表的后继
+  TimerEntry** _slot{nullptr};               // 所在槽位的链表头，未链接时为空
+  std::shared_ptr<TimerEntry> _self{};       // 链接期间持有自己
+  std::atomic<TimerWheel*> _wheel{nullptr};  // 所属时间轮
+  std::atomic<bool> _cancelled{false};       // 是否已取消
+
+  [[nodiscard]]
+  bool cancelled() const {
+    return _cancelled.load(std::memory_order::acquire);
+  }
+
+  // 取消定时器，返回是否取消成功(定义在 TimerWheel 之后)
+  bool cancel();
+
+  // 执行到期的回调：一次性定时器只执行一次，并且不能与取消同时成功
+  void fire() {
+    if (_period != 0) {
+      if (!cancelled()) _callback();
+      rearm();
+    } else if (!_cancelled.exchange(true, std::memory_order::acq_rel)) {
+      _callback();
+    }
+  }
+
+  // 到期的任务被丢弃：周期定时器跳过这一次，等下一个周期
+  void skip() {
+    if (_period != 0) rearm();
+  }
+
+ private:
+  // 周期定时器重新插入时间轮(定义在 TimerWheel 之后)
+  void rearm();
+};
+
+// 分层时间轮：4 层，每层 64 个槽位，tick 为 1ms，
+// 第 l 层的一个槽位覆盖 64^l 个 tick，能直接表示约 194 天内的定时器，
+// 更远的定时器先放在最高层，到期时再重新插入
+// 插入和取消都是 O(1)：计算槽位后挂到链表上，或从链表上摘下
+// 到期处理时低层槽位轮转一圈，就把高一层对应槽位的定时器下放到低层
+// 由 worker 在调度循环中驱动，外部线程也可以插入和取消，所以用互斥锁保护
+class TimerWheel : util::noncopyable {
+ public:
+  constexpr static inline auto TICK = std::chrono::milliseconds(1);
+
+ public:
+  TimerWheel() = default;
+
+  ~TimerWheel() { clear(); }
+
+  // 取消并释放所有未到期的定时器，之后它们的句柄取消失败
+  void clear() {
+    std::lock_guard lock{_mutex};
+    for (auto& level : _slots) {
+      for (auto& head : level) {
+        while (head != nullptr) {
+          auto entry = head;
+          unlink(entry);
+          entry->_cancelled.store(true, std::memory_order::release);
+          entry->_wheel.store(nullptr, std::memory_order::release);
+          auto self = std::move(entry->_self);
+        }
+      }
+    }
+  }
+
+ public:
+  // 未到期的定时器数量，不加锁读取
+  [[nodiscard]]
+  std::size_t size() const {
+    return _count.load(std::memory_order::acquire);
+  }
+
+  [[nodiscard]]
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // 最早需要推进时间轮的时间，没有定时器时返回空
+  // 高层槽位按下放的时间计算，返回值不晚于真正的最早到期时间，
+  // 在这个时间推进后再次查询即可；worker 据此休眠，不需要每个 tick 轮询
+  [[nodiscard]]
+  std::optional<deadline_clock::time_point> next_expiry() {
+    std::lock_guard lock{_mutex};
+    if (empty()) {
+      return std::nullopt;
+    }
+    auto next = std::numeric_limits<std::uint64_t>::max();
+    for (std::size_t level = 0; level < LEVELS; ++level) {
+      // 第 level 层的槽位在 tick 是 64^level 的整数倍、且这一层的下标等于
+      // 槽位下标时处理(第 0 层到期，更高层下放)，取当前 tick 之后第一次
+      auto shift = SLOT_BITS * level;
+      auto first = (_current >> shift) + 1;
+      for (std::size_t index = 0; index < SLOTS; ++index) {
+        if (_slots[level][index] == nullptr) {
+          continue;
+        }
+        auto block = first + ((index - first) & (SLOTS - 1));
+        next = std::min(next, block << shift);
+      }
+    }
+    return _start + next * TICK;
+  }
+
+  // 插入定时器：在 when 到期，period 不为 0 时之后每隔 period 再次到期
+  std::shared_ptr<TimerEntry> insert(deadline_clock::time_point when,
+                                     deadline_clock::duration period,
+                                     std::function<void()> callback) {
+    auto entry = std::make_shared<TimerEntry>();
+    entry->_callback = std::move(callback);
+    entry->_wheel.store(this, std::memory_order::release);
+    if (period > deadline_clock::duration::zero()) {
+      entry->_period = std::max<std::uint64_t>(1, ticks_ceil(period));
+    }
+    std::lock_guard lock{_mutex};
+    entry->_expires = tick_of(when);
+    entry->_self = entry;
+    link(entry.get());
+    return entry;
+  }
+
+  // 取消定时器，返回是否取消成功(之后回调不会再被执行)
+  // 一次性定时器的回调开始执行时也会置上取消标记，此后取消失败
+  bool cancel(TimerEntry* entry) {
+    std::lock_guard lock{_mutex};
+    if (entry->_cancelled.exchange(true, std::memory_order::acq_rel)) {
+      return false;
+    }
+    entry->_wheel.store(nullptr, std::memory_order::release);
+    // 已经到期、回调还没有执行完的定时器不在槽位上，置上标记即可
+    if (entry->_slot != nullptr) {
+      unlink(entry);
+      auto self = std::move(entry->_self);
+    }
+    return true;
+  }
+
+  // 周期定时器的回调执行完后重新插入，下次到期时间为上次的到期时间加上周期，
+  // 已经错过时顺延到下一个 tick；期间被取消时不再插入
+  void rearm(TimerEntry* entry) {
+    std::lock_guard lock{_mutex};
+    if (entry->cancelled()) {
+      return;
+    }
+    entry->_expires =
+        std::max(_current + 1, entry->_expires + entry->_period);
+    entry->_self = entry->shared_from_this();
+    link(entry);
+  }
+
+  // 推进时间轮到 now，把到期的定时器追加到 expired，它们都解除链接
+  void advance(deadline_clock::time_point now,
+               std::vector<std::shared_ptr<TimerEntry>>& expired) {
+    std::lock_guard lock{_mutex};
+    auto target = ticks_floor(now - _start);
+    if (empty()) {
+      // 没有定时器时直接跳到目标 tick
+      _current = std::max(_current, target);
+      return;
+    }
+    while (_current < target) {
+      ++_current;
+      // 低层槽位轮转一圈时，从高层依次下放
+      for (std::size_t level = 1; level < LEVELS; ++level) {
+        if ((_current & ((std::uint64_t{1} << (SLOT_BITS * level)) - 1)) !=
+            0) {
+          break;
+        }
+        cascade(level, slot_index(_current, level));
+      }
+      auto& head = _slots[0][slot_index(_current, 0)];
+      while (head != nullptr) {
+        auto entry = head;
+        unlink(entry);
+        if (entry->_expires > _current) {
+          // 超出时间轮范围的定时器，还没有真正到期
+          link(entry);
+          continue;
+        }
+        // 周期定时器等回调执行完再由 rearm 重新插入；
+        // 一次性定时器不再属于时间轮，之后取消不会访问时间轮
+        if (entry->_period == 0) {
+          entry->_wheel.store(nullptr, std::memory_order::release);
+        }
+        expired.push_back(std::move(entry->_self));
+      }
+      if (empty()) {
+        _current = target;
+        break;
+      }
+    }
+  }
+
+ private:
+  constexpr static inline std::size_t LEVELS = 4;
+  constexpr static inline std::size_t SLOT_BITS = 6;
+  constexpr static inline std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+  constexpr static inline std::uint64_t MAX_TICKS =
+      std::uint64_t{1} << (SLOT_BITS * LEVELS);
+
+  static std::uint64_t ticks_floor(deadline_clock::duration d) {
+    if (d <= deadline_clock::duration::zero()) return 0;
+    return static_cast<std::uint64_t>(d / TICK);
+  }
+
+  static std::uint64_t ticks_ceil(deadline_clock::duration d) {
+    if (d <= deadline_clock::duration::zero()) return 0;
+    auto ticks = static_cast<std::uint64_t>(d / TICK);
+    return d % TICK != deadline_clock::duration::zero() ? ticks + 1 : ticks;
+  }
+
+  static std::size_t slot_index(std::uint64_t tick, std::size_t level) {
+    return static_cast<std::size_t>((tick >> (SLOT_BITS * level)) &
+                                    (SLOTS - 1));
+  }
+
+  // 到期时间对应的 tick(调用方持有锁)，向上取整，不早于下一个 tick
+  std::uint64_t tick_of(deadline_clock::time_point when) const {
+    return std::max(_current + 1, ticks_ceil(when - _start));
+  }
+
+  // 按距离当前 tick 的远近把定时器挂到对应层的槽位(调用方持有锁)
+  void link(TimerEntry* entry) {
+    auto expires = std::min(entry->_expires, _current + MAX_TICKS - 1);
+    auto delta = expires - _current;
+    std::size_t level = 0;
+    while (level + 1 < LEVELS &&
+           delta >= (std::uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+      ++level;
+    }
+    auto& head = _slots[level][slot_index(expires, level)];
+    entry->_slot = &head;
+    entry->_prev = nullptr;
+    entry->_next = head;
+    if (head != nullptr) head->_prev = entry;
+    head = entry;
+    _count.fetch_add(1, std::memory_order::release);
+  }
+
+  // 从槽位链表上摘下定时器(调用方持有锁)
+  void unlink(TimerEntry* entry) {
+    if (entry->_prev != nullptr) {
+      entry->_prev->_next = entry->_next;
+    } else {
+      *entry->_slot = entry->_next;
+    }
+    if (entry->_next != nullptr) entry->_next->_prev = entry->_prev;
+    entry->_prev = entry->_next = nullptr;
+    entry->_slot = nullptr;
+    _count.fetch_sub(1, std::memory_order::release);
+  }
+
+  // 把高层槽位的定时器重新插入，它们会落到更低的层(调用方持有锁)
+  void cascade(std::size_t level, std::size_t index) {
+    auto head = std::exchange(_slots[level][index], nullptr);
+    while (head != nullptr) {
+      auto entry = head;
+      head = entry->_next;
+      entry->_prev = entry->_next = nullptr;
+      entry->_slot = nullptr;
+      _count.fetch_sub(1, std::memory_order::release);
+      link(entry);
+    }
+  }
+
+ private:
+  using level_type = std::array<TimerEntry*, SLOTS>;
+
+  std::mutex _mutex{};                      // 保护槽位和当前 tick
+  std::array<level_type, LEVELS> _slots{};  // 各层槽位的链表头
+  std::uint64_t _current{0};                // 已经处理到的 tick
+  deadline_clock::time_point _start{deadline_clock::now()};  // tick 0 的时间
+  std::atomic<std::size_t> _count{0};       // 未到期的定时器数量
+};
+
+inline void TimerEntry::rearm() {
+  auto wheel = _wheel.load(std::memory_order::acquire);
+  if (wheel != nullptr) {
+    wheel->rearm(this);
+  }
+}
+
+// 已经取消、执行过或时间轮已经清空的定时器不访问时间轮(它可能已经销毁)；
+// 已经从时间轮摘下、回调还没有执行的一次性定时器只需置上取消标记
+inline bool TimerEntry::cancel() {
+  if (cancelled()) {
+    return false;
+  }
+  auto wheel = _wheel.load(std::memory_order::acquire);
+  if (wheel == nullptr) {
+    return !_cancelled.exchange(true, std::memory_order::acq_rel);
+  }
+  return wheel->cancel(this);
+}
+
+// 定时器句柄，用于取消定时器，默认构造的句柄不关联任何定时器
+class TimerHandle {
+ public:
+  TimerHandle() = default;
+  explicit TimerHandle(std::shared_ptr<TimerEntry> entry)
+      : _entry(std::move(entry)) {}
+
+ public:
+  // 取消定时器，返回是否取消成功(之后回调不会再被执行)
+  bool cancel() { return _entry != nullptr && _entry->cancel(); }
+
+  // 回调之后是否还会被执行(一次性定时器执行后、定时器取消后返回 false)
+  [[nodiscard]]
+  bool active() const {
+    return _entry != nullptr && !_entry->cancelled();
+  }
+
+ private:
+  std::shared_ptr<TimerEntry> _entry{};
+};
+}  // namespace fastexec::detail
+
+#endif
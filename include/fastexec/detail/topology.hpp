@@ -0,0 +1,234 @@
+#ifndef __FASTSTDEXEC_DETAIL_TOPOLOGY_HPP
+#define __FASTSTDEXEC_DETAIL_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace fastexec::detail {
+// 单个逻辑 CPU 的拓扑信息，每个域用域内编号最小的 CPU(或节点号)作为标识
+struct CpuInfo {
+  int cpu{0};   // 逻辑 CPU 编号
+  int core{0};  // 物理核心，SMT 兄弟线程相同
+  int l3{0};    // 共享 L3 缓存的域
+  int node{0};  // NUMA 节点
+};
+
+// CPU 拓扑，从 /sys/devices/system/cpu 读取
+// 只包含当前进程允许运行的 CPU，读取失败的部分退化为同一个域
+class Topology {
+ public:
+  static Topology detect() {
+    Topology topo;
+    for (auto cpu : allowed_cpus()) {
+      topo._cpus.push_back(read_cpu_info(cpu));
+    }
+    // 按 (节点, L3, 核心, CPU) 排序，相邻的 CPU 在拓扑上也相邻
+    std::ranges::sort(topo._cpus, {}, [](const CpuInfo& c) {
+      return std::tuple{c.node, c.l3, c.core, c.cpu};
+    });
+    for (auto& c : topo._cpus) {
+      if (std::ranges::find(topo._nodes, c.node) == topo._nodes.end()) {
+        topo._nodes.push_back(c.node);
+      }
+    }
+    return topo;
+  }
+
+ public:
+  // 按拓扑顺序排列的可用 CPU
+  [[nodiscard]]
+  std::span<const CpuInfo> cpus() const {
+    return _cpus;
+  }
+
+  // NUMA 节点数量
+  [[nodiscard]]
+  std::size_t node_count() const {
+    return _nodes.size();
+  }
+
+  // 返回 NUMA 节点号对应的下标(从 0 开始连续编号)，未知节点返回 0
+  [[nodiscard]]
+  std::size_t node_index(int node) const {
+    auto it = std::ranges::find(_nodes, node);
+    return it == _nodes.end() ? 0
+                              : static_cast<std::size_t>(it - _nodes.begin());
+  }
+
+  // 返回逻辑 CPU 所在 NUMA 节点的下标，未知 CPU 返回 0
+  [[nodiscard]]
+  std::size_t node_index_of_cpu(int cpu) const {
+    auto it = std::ranges::find(_cpus, cpu, &CpuInfo::cpu);
+    return it == _cpus.end() ? 0 : node_index(it->node);
+  }
+
+  // 当前进程实际可以使用的并行度：亲和性掩码中的 CPU 数，
+  // 再受 cgroup CPU 配额限制(向上取整)，容器中不会按宿主机的核数创建线程
+  static std::size_t available_parallelism() {
+    auto count = allowed_cpus().size();
+    if (auto quota = cgroup_cpu_quota(); quota.has_value()) {
+      count = std::min(count, static_cast<std::size_t>(std::ceil(*quota)));
+    }
+    return std::max<std::size_t>(1, count);
+  }
+
+  // cgroup 的 CPU 配额(可以同时使用的 CPU 数)，没有限制或读取失败返回空
+  // cgroup v2 读取 cpu.max("配额 周期"，不限制时配额为 max)，从进程所在的
+  // cgroup 向上直到根，取最严格的一层；v1 读取 cpu.cfs_quota_us 和
+  // cpu.cfs_period_us(不限制时配额为 -1)
+  static std::optional<double> cgroup_cpu_quota() {
+    namespace fs = std::filesystem;
+    std::optional<double> result;
+    auto update = [&](double quota) {
+      if (quota > 0 && (!result.has_value() || quota < *result)) {
+        result = quota;
+      }
+    };
+    std::ifstream cgroup("/proc/self/cgroup");
+    std::string line;
+    // 每行形如 "层级:控制器列表:路径"，v2 的控制器列表为空
+    while (std::getline(cgroup, line)) {
+      auto first = line.find(':');
+      auto second = line.find(':', first + 1);
+      if (first == std::string::npos || second == std::string::npos) continue;
+      auto controllers = "," + line.substr(first + 1, second - first - 1) + ",";
+      auto path = fs::path{line.substr(second + 1)}.relative_path();
+      if (controllers == ",,") {
+        auto root = fs::path{"/sys/fs/cgroup"};
+        for (auto dir = root / path;; dir = dir.parent_path()) {
+          std::istringstream in(read_text(dir / "cpu.max"));
+          double quota = 0, period = 0;
+          if (in >> quota >> period && period > 0) {
+            update(quota / period);
+          }
+          if (dir == root || !dir.has_relative_path()) break;
+        }
+      } else if (controllers.find(",cpu,") != std::string::npos) {
+        for (auto mount : {"/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu"}) {
+          for (auto dir : {fs::path{mount} / path, fs::path{mount}}) {
+            std::istringstream in(read_text(dir / "cpu.cfs_quota_us") + " " +
+                                  read_text(dir / "cpu.cfs_period_us"));
+            double quota = 0, period = 0;
+            if (!(in >> quota >> period)) continue;
+            if (period > 0) {
+              update(quota / period);
+            }
+            break;
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+ private:
+  Topology() = default;
+
+  // 当前进程允许运行的 CPU 列表
+  static std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+      }
+    }
+#endif
+    if (cpus.empty()) {
+      auto n = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned cpu = 0; cpu < n; ++cpu) {
+        cpus.push_back(static_cast<int>(cpu));
+      }
+    }
+    return cpus;
+  }
+
+  static CpuInfo read_cpu_info(int cpu) {
+    namespace fs = std::filesystem;
+    auto dir =
+        fs::path{"/sys/devices/system/cpu"} / ("cpu" + std::to_string(cpu));
+    CpuInfo info{cpu, cpu, cpu, 0};
+
+    // SMT 兄弟线程
+    if (auto first = read_first_cpu(dir / "topology" / "thread_siblings_list");
+        first >= 0) {
+      info.core = first;
+    }
+    info.l3 = info.core;
+    // 共享 L3 的 CPU：在 cache/indexN 中找到 level 为 3 的那一项
+    std::error_code ec;
+    for (int i = 0;; ++i) {
+      auto index = dir / "cache" / ("index" + std::to_string(i));
+      if (!fs::exists(index, ec)) break;
+      if (read_text(index / "level") == "3") {
+        if (auto first = read_first_cpu(index / "shared_cpu_list");
+            first >= 0) {
+          info.l3 = first;
+        }
+        break;
+      }
+    }
+    // NUMA 节点：cpuN 目录下的 nodeM 链接
+    for (auto it = fs::directory_iterator(dir, ec);
+         !ec && it != fs::directory_iterator(); it.increment(ec)) {
+      auto name = it->path().filename().string();
+      if (name.size() > 4 && name.starts_with("node") &&
+          name.find_first_not_of("0123456789", 4) == std::string::npos) {
+        info.node = std::stoi(name.substr(4));
+        break;
+      }
+    }
+    return info;
+  }
+
+  // 读取文件的第一行，失败返回空串
+  static std::string read_text(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+  }
+
+  // 解析形如 "0-3,8,10-11" 的 CPU 列表，返回其中最小的 CPU，失败返回 -1
+  static int read_first_cpu(const std::filesystem::path& path) {
+    auto text = read_text(path);
+    int first = -1;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      auto end = text.find(',', pos);
+      if (end == std::string::npos) end = text.size();
+      auto item = text.substr(pos, end - pos);
+      if (!item.empty() && item.front() >= '0' && item.front() <= '9' &&
+          item.find_first_not_of("0123456789-") == std::string::npos) {
+        // 区间 "a-b" 的最小值是 a
+        auto cpu = std::stoi(item.substr(0, item.find('-')));
+        if (first < 0 || cpu < first) first = cpu;
+      }
+      pos = end + 1;
+    }
+    return first;
+  }
+
+ private:
+  std::vector<CpuInfo> _cpus{};  // 可用 CPU，按拓扑顺序排列
+  std::vector<int> _nodes{};     // 出现过的 NUMA 节点号
+};
+}  // namespace fastexec::detail
+
+#endif
@@ -0,0 +1,559 @@
+#ifndef __FASTSTDEXEC_DETAIL_URING_HPP
+#define __FASTSTDEXEC_DETAIL_URING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "blocking.hpp"
+#include "coro.hpp"
+#include "reactor.hpp"
+#include "util.hpp"
+namespace fastexec::detail {
+class IoUring;
+// 线程局部存储，当前任务中提交了 SQE 但还没有提交给内核的 ring
+// worker 在任务执行完后统一提交，同一个任务内的多次提交合并成一次系统调用
+static inline thread_local IoUring* t_uring_flush{nullptr};
+
+// 文件操作的类型和参数
+struct FileOp {
+  enum class Kind { read, write };
+  Kind _kind{Kind::read};
+  int _fd{-1};
+  void* _data{nullptr};
+  std::size_t _size{0};
+  std::uint64_t _offset{0};
+  int _buf_index{-1};  // 注册缓冲区的下标，-1 表示普通缓冲区
+};
+
+// 文件操作完成回调，参数为读写的字节数，失败时为 -errno
+using FileCompletion = std::function<void(std::int64_t)>;
+
+// 同步执行文件操作，返回读写的字节数，失败时为 -errno
+inline std::int64_t run_file_op(const FileOp& op) {
+#ifdef __linux__
+  auto res = op._kind == FileOp::Kind::read
+                 ? ::pread(op._fd, op._data, op._size,
+                           static_cast<off_t>(op._offset))
+                 : ::pwrite(op._fd, op._data, op._size,
+                            static_cast<off_t>(op._offset));
+  return res < 0 ? -errno : res;
+#else
+  (void)op;
+  return -38;  // ENOSYS
+#endif
+}
+
+#ifdef __linux__
+// io_uring 的最小封装，直接使用系统调用，不依赖 liburing
+// SQ 和 CQ 各由一个互斥锁保护，任何线程都可以提交，完成事件通过 eventfd 通知
+// 内核持续拒绝接收(EAGAIN/EBUSY)的操作从 SQ 中撤回，交给 fallback 执行
+class IoUring : util::noncopyable {
+ public:
+  using fallback_type = std::function<void(const FileOp&, FileCompletion)>;
+
+  // 内核暂时无法接收时重试提交的次数
+  constexpr static inline int SUBMIT_RETRIES = 16;
+
+ public:
+  // 创建失败(内核不支持、被 seccomp 禁止等)返回空
+  static std::unique_ptr<IoUring> create(unsigned entries,
+                                         fallback_type fallback) {
+    std::unique_ptr<IoUring> ring{new IoUring()};
+    ring->_fallback = std::move(fallback);
+    if (!ring->setup(entries)) {
+      return nullptr;
+    }
+    return ring;
+  }
+
+  ~IoUring() {
+    if (_sqes != nullptr) ::munmap(_sqes, _sqes_size);
+    if (_cq_ptr != nullptr && _cq_ptr != _sq_ptr) ::munmap(_cq_ptr, _cq_size);
+    if (_sq_ptr != nullptr) ::munmap(_sq_ptr, _sq_size);
+    if (_event_fd >= 0) ::close(_event_fd);
+    if (_ring_fd >= 0) ::close(_ring_fd);
+  }
+
+ public:
+  // 完成事件通知用的 eventfd
+  [[nodiscard]]
+  int event_fd() const {
+    return _event_fd;
+  }
+
+  // 正在执行的操作数量
+  [[nodiscard]]
+  std::size_t inflight() const {
+    return _inflight.load(std::memory_order::acquire);
+  }
+
+  // 注册固定缓冲区，失败(如超过 RLIMIT_MEMLOCK)返回 false
+  bool register_buffers(std::span<const iovec> buffers) {
+    return ::syscall(__NR_io_uring_register, _ring_fd,
+                     IORING_REGISTER_BUFFERS, buffers.data(),
+                     static_cast<unsigned>(buffers.size())) == 0;
+  }
+
+  // 把操作放入 SQ，暂不提交给内核，成功时取走 completion
+  // SQ 已满或正在执行的操作过多时返回 false
+  bool prepare(const FileOp& op, FileCompletion& completion) {
+    std::lock_guard lock{_sq_mutex};
+    // 限制正在执行的操作数量不超过 CQ 容量，避免 CQ 溢出
+    if (_inflight.load(std::memory_order::relaxed) >= _cq_entries) {
+      return false;
+    }
+    auto head = std::atomic_ref(*_sq_head).load(std::memory_order::acquire);
+    auto tail = *_sq_tail;
+    if (tail - head >= _sq_entries) {
+      submit_locked();
+      head = std::atomic_ref(*_sq_head).load(std::memory_order::acquire);
+      if (tail - head >= _sq_entries) return false;
+    }
+    auto index = tail & _sq_mask;
+    auto& sqe = _sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    bool fixed = op._buf_index >= 0;
+    if (op._kind == FileOp::Kind::read) {
+      sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    } else {
+      sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    }
+    sqe.fd = op._fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(op._data);
+    sqe.len = static_cast<std::uint32_t>(op._size);
+    sqe.off = op._offset;
+    if (fixed) sqe.buf_index = static_cast<std::uint16_t>(op._buf_index);
+    sqe.user_data = reinterpret_cast<std::uint64_t>(
+        new FileCompletion(std::move(completion)));
+    _sq_array[index] = index;
+    std::atomic_ref(*_sq_tail).store(tail + 1, std::memory_order::release);
+    ++_to_submit;
+    _inflight.fetch_add(1, std::memory_order::release);
+    return true;
+  }
+
+  // 把已放入 SQ 的操作一次性提交给内核
+  void flush() {
+    std::lock_guard lock{_sq_mutex};
+    submit_locked();
+  }
+
+  // 取出所有完成事件，追加到 done
+  void reap(std::vector<std::pair<FileCompletion, std::int64_t>>& done) {
+    std::lock_guard lock{_cq_mutex};
+    auto head = *_cq_head;
+    auto tail = std::atomic_ref(*_cq_tail).load(std::memory_order::acquire);
+    std::size_t count = 0;
+    for (; head != tail; ++head, ++count) {
+      auto& cqe = _cqes[head & _cq_mask];
+      std::unique_ptr<FileCompletion> completion{
+          reinterpret_cast<FileCompletion*>(cqe.user_data)};
+      done.emplace_back(std::move(*completion), cqe.res);
+    }
+    std::atomic_ref(*_cq_head).store(head, std::memory_order::release);
+    _inflight.fetch_sub(count, std::memory_order::release);
+  }
+
+  // 阻塞等待所有正在执行的操作完成并丢弃它们的回调(析构前调用)
+  void drain() {
+    flush();
+    std::vector<std::pair<FileCompletion, std::int64_t>> done;
+    while (inflight() > 0) {
+      ::syscall(__NR_io_uring_enter, _ring_fd, 0, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0);
+      reap(done);
+      done.clear();
+    }
+  }
+
+ private:
+  IoUring() = default;
+
+  bool setup(unsigned entries) {
+    io_uring_params params{};
+    _ring_fd = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, entries, &params));
+    if (_ring_fd < 0) return false;
+    _sq_entries = params.sq_entries;
+    _cq_entries = params.cq_entries;
+
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+    _sq_ptr = map(_sq_size, IORING_OFF_SQ_RING);
+    if (_sq_ptr == nullptr) return false;
+    _cq_ptr = single ? _sq_ptr : map(_cq_size, IORING_OFF_CQ_RING);
+    if (_cq_ptr == nullptr) return false;
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe*>(map(_sqes_size, IORING_OFF_SQES));
+    if (_sqes == nullptr) return false;
+
+    auto sq = static_cast<char*>(_sq_ptr);
+    _sq_head = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+    auto cq = static_cast<char*>(_cq_ptr);
+    _cq_head = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    _event_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_event_fd < 0) return false;
+    return ::syscall(__NR_io_uring_register, _ring_fd,
+                     IORING_REGISTER_EVENTFD, &_event_fd, 1) == 0;
+  }
+
+  void* map(std::size_t size, std::uint64_t offset) {
+    auto ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, _ring_fd,
+                      static_cast<off_t>(offset));
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  // 提交 SQ 中的操作(调用方持有 SQ 锁)
+  // EAGAIN/EBUSY 表示内核暂时无法接收，让出 CPU 后重试；多次重试仍失败时
+  // 撤回剩余的操作交给 fallback，否则它们留在 SQ 中没有人再提交，等待者永远挂起
+  void submit_locked() {
+    int retries = 0;
+    while (_to_submit > 0) {
+      auto n = ::syscall(__NR_io_uring_enter, _ring_fd, _to_submit, 0, 0,
+                         nullptr, 0);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if ((errno == EAGAIN || errno == EBUSY) && ++retries < SUBMIT_RETRIES) {
+          std::this_thread::yield();
+          continue;
+        }
+        reclaim_locked();
+        return;
+      }
+      _to_submit -= static_cast<unsigned>(n);
+    }
+  }
+
+  // 撤回 SQ 尾部还没有被内核取走的操作，交给 fallback(调用方持有 SQ 锁)
+  // 没有使用 SQPOLL，内核只在 io_uring_enter 中读取 SQ，持锁回退 SQ 尾是安全的
+  void reclaim_locked() {
+    auto tail = *_sq_tail;
+    auto begin = tail - _to_submit;
+    std::atomic_ref(*_sq_tail).store(begin, std::memory_order::release);
+    _inflight.fetch_sub(_to_submit, std::memory_order::release);
+    _to_submit = 0;
+    for (auto i = begin; i != tail; ++i) {
+      const auto& sqe = _sqes[_sq_array[i & _sq_mask]];
+      FileOp op;
+      op._kind = sqe.opcode == IORING_OP_READ ||
+                         sqe.opcode == IORING_OP_READ_FIXED
+                     ? FileOp::Kind::read
+                     : FileOp::Kind::write;
+      op._fd = sqe.fd;
+      op._data = reinterpret_cast<void*>(sqe.addr);
+      op._size = sqe.len;
+      op._offset = sqe.off;
+      std::unique_ptr<FileCompletion> completion{
+          reinterpret_cast<FileCompletion*>(sqe.user_data)};
+      _fallback(op, std::move(*completion));
+    }
+  }
+
+ private:
+  int _ring_fd{-1};                       // io_uring 实例
+  int _event_fd{-1};                      // 完成事件通知
+  void* _sq_ptr{nullptr};                 // SQ ring 映射
+  void* _cq_ptr{nullptr};                 // CQ ring 映射
+  std::size_t _sq_size{0};                // SQ ring 映射大小
+  std::size_t _cq_size{0};                // CQ ring 映射大小
+  io_uring_sqe* _sqes{nullptr};           // SQE 数组
+  std::size_t _sqes_size{0};              // SQE 数组映射大小
+  std::uint32_t* _sq_head{nullptr};       // SQ 头(内核更新)
+  std::uint32_t* _sq_tail{nullptr};       // SQ 尾(用户更新)
+  std::uint32_t* _sq_array{nullptr};      // SQ 下标数组
+  std::uint32_t _sq_mask{0};              // SQ 掩码
+  std::uint32_t _sq_entries{0};           // SQ 容量
+  std::uint32_t* _cq_head{nullptr};       // CQ 头(用户更新)
+  std::uint32_t* _cq_tail{nullptr};       // CQ 尾(内核更新)
+  io_uring_cqe* _cqes{nullptr};           // CQE 数组
+  std::uint32_t _cq_mask{0};              // CQ 掩码
+  std::uint32_t _cq_entries{0};           // CQ 容量
+  unsigned _to_submit{0};                 // 已放入 SQ 但还没有提交的数量
+  std::mutex _sq_mutex{};                 // 保护 SQ
+  std::mutex _cq_mutex{};                 // 保护 CQ
+  std::atomic<std::size_t> _inflight{0};  // 正在执行的操作数量
+  fallback_type _fallback{};              // 执行内核拒绝接收的操作
+};
+#endif
+
+// 文件 I/O：优先使用 io_uring，不可用时退化为在阻塞任务线程池中 pread/pwrite
+// io_uring 实例在第一次使用时创建，完成事件的 eventfd 交给 reactor 等待，
+// 就绪后由 worker 取出完成事件，把回调作为任务交给线程池执行
+// 同时预先注册一组固定缓冲区，从中分配的缓冲区读写时使用 READ/WRITE_FIXED
+class FileIo : util::noncopyable {
+ public:
+  using schedule_type = std::function<void(std::function<void()>)>;
+
+  constexpr static inline unsigned RING_ENTRIES = 256;
+  constexpr static inline std::size_t BUFFER_COUNT = 16;
+  constexpr static inline std::size_t BUFFER_SIZE = 64 * 1024;
+
+ public:
+  FileIo(Reactor& reactor, BlockingPool& blocking, schedule_type schedule)
+      : _reactor(reactor),
+        _blocking(blocking),
+        _schedule(std::move(schedule)) {}
+
+  ~FileIo() {
+#ifdef __linux__
+    if (_ring) _ring->drain();
+#endif
+    std::free(_buffers);
+  }
+
+ public:
+  // 提交文件操作，完成时 completion 作为任务在线程池中执行
+  // defer_flush 为 true(worker 线程)时，SQE 在当前任务结束后统一提交给内核
+  void submit(const FileOp& op, FileCompletion completion, bool defer_flush) {
+#ifdef __linux__
+    std::call_once(_init_flag, [this]() { init(); });
+    if (_ring && _ring->prepare(op, completion)) {
+      arm();
+      if (defer_flush) {
+        if (t_uring_flush != nullptr && t_uring_flush != _ring.get()) {
+          t_uring_flush->flush();
+        }
+        t_uring_flush = _ring.get();
+      } else {
+        _ring->flush();
+      }
+      return;
+    }
+#endif
+    // io_uring 不可用或暂时已满，在阻塞任务线程池中执行
+    run_blocking(op, std::move(completion));
+  }
+
+  // 是否使用 io_uring
+  [[nodiscard]]
+  bool uses_uring() {
+    std::call_once(_init_flag, [this]() { init(); });
+    return _ring != nullptr;
+  }
+
+  // 分配一个固定缓冲区，返回其下标，没有空闲缓冲区时返回 -1
+  int acquire_buffer() {
+    std::call_once(_init_flag, [this]() { init(); });
+    std::lock_guard lock{_buffer_mutex};
+    if (_free_buffers.empty()) return -1;
+    auto index = _free_buffers.back();
+    _free_buffers.pop_back();
+    return index;
+  }
+
+  // 归还固定缓冲区
+  void release_buffer(int index) {
+    std::lock_guard lock{_buffer_mutex};
+    _free_buffers.push_back(index);
+  }
+
+  // 固定缓冲区的内存
+  std::span<std::byte> buffer(int index) {
+    return {_buffers + static_cast<std::size_t>(index) * BUFFER_SIZE,
+            BUFFER_SIZE};
+  }
+
+  // 数据位于某个已注册的固定缓冲区内时返回它的下标，否则返回 -1
+  int registered_index(const void* data, std::size_t size) const {
+    if (!_registered || _buffers == nullptr) return -1;
+    auto begin = reinterpret_cast<std::uintptr_t>(_buffers);
+    auto p = reinterpret_cast<std::uintptr_t>(data);
+    if (p < begin || p + size > begin + BUFFER_COUNT * BUFFER_SIZE) return -1;
+    auto index = (p - begin) / BUFFER_SIZE;
+    if ((p + size - begin - 1) / BUFFER_SIZE != index && size > 0) return -1;
+    return static_cast<int>(index);
+  }
+
+ private:
+  void init() {
+    _buffers = static_cast<std::byte*>(
+        std::aligned_alloc(4096, BUFFER_COUNT * BUFFER_SIZE));
+    for (std::size_t i = BUFFER_COUNT; i > 0; --i) {
+      _free_buffers.push_back(static_cast<int>(i - 1));
+    }
+#ifdef __linux__
+    // 内核拒绝接收的操作同样退化到阻塞任务线程池，
+    // 这时已经没有可以抛出异常的提交方，线程池已关闭时以 -ECANCELED 完成
+    _ring = IoUring::create(
+        RING_ENTRIES, [this](const FileOp& op, FileCompletion completion) {
+          auto shared =
+              std::make_shared<FileCompletion>(std::move(completion));
+          try {
+            run_blocking(op, [shared](std::int64_t res) { (*shared)(res); });
+          } catch (const std::runtime_error&) {
+            _schedule([shared]() { (*shared)(-ECANCELED); });
+          }
+        });
+    if (_ring && _buffers != nullptr) {
+      std::vector<iovec> iovecs(BUFFER_COUNT);
+      for (std::size_t i = 0; i < BUFFER_COUNT; ++i) {
+        iovecs[i].iov_base = _buffers + i * BUFFER_SIZE;
+        iovecs[i].iov_len = BUFFER_SIZE;
+      }
+      _registered = _ring->register_buffers(iovecs);
+    }
+#endif
+  }
+
+  // 在阻塞任务线程池中执行操作，完成回调交给线程池
+  void run_blocking(const FileOp& op, FileCompletion completion) {
+    _blocking.submit([this, op, completion = std::move(completion)]() mutable {
+      auto res = run_file_op(op);
+      _schedule([completion = std::move(completion), res]() {
+        completion(res);
+      });
+    });
+  }
+
+#ifdef __linux__
+  // 有正在执行的操作时，让 reactor 等待完成事件的 eventfd
+  void arm() {
+    if (_armed.exchange(true, std::memory_order::acq_rel)) return;
+    try {
+      _reactor.add_waiter(_ring->event_fd(), Readiness::readable,
+                          [this]() { on_complete(); });
+    } catch (...) {
+      _armed.store(false, std::memory_order::release);
+      throw;
+    }
+  }
+
+  // eventfd 可读：先清空计数再取出完成事件，之后到达的完成事件会再次触发
+  void on_complete() {
+    _armed.store(false, std::memory_order::release);
+    std::uint64_t value;
+    while (::read(_ring->event_fd(), &value, sizeof(value)) > 0) {
+    }
+    std::vector<std::pair<FileCompletion, std::int64_t>> done;
+    _ring->reap(done);
+    if (_ring->inflight() > 0) {
+      arm();
+    }
+    for (auto& [completion, res] : done) {
+      _schedule([completion = std::move(completion), res]() {
+        completion(res);
+      });
+    }
+  }
+#endif
+
+ private:
+  Reactor& _reactor;                 // 等待完成事件
+  BlockingPool& _blocking;           // io_uring 不可用时执行操作
+  schedule_type _schedule;           // 把完成回调交给线程池
+  std::once_flag _init_flag{};       // 延迟创建 io_uring
+#ifdef __linux__
+  std::unique_ptr<IoUring> _ring{};  // io_uring 实例，不可用时为空
+#endif
+  std::atomic<bool> _armed{false};   // 是否已让 reactor 等待完成事件
+  std::byte* _buffers{nullptr};      // 固定缓冲区内存
+  bool _registered{false};           // 固定缓冲区是否已注册到 io_uring
+  std::mutex _buffer_mutex{};        // 保护空闲缓冲区列表
+  std::vector<int> _free_buffers{};  // 空闲的固定缓冲区下标
+};
+
+// 固定缓冲区：优先从已注册到 io_uring 的缓冲区中分配，
+// 用它读写时内核不需要每次都锁定用户内存；没有空闲的注册缓冲区时退化为堆内存
+class FixedBuffer : util::noncopyable {
+ public:
+  explicit FixedBuffer(FileIo& io) : _io(&io), _index(io.acquire_buffer()) {
+    if (_index >= 0) {
+      _data = io.buffer(_index);
+    } else {
+      _heap = std::make_unique<std::byte[]>(FileIo::BUFFER_SIZE);
+      _data = {_heap.get(), FileIo::BUFFER_SIZE};
+    }
+  }
+  FixedBuffer(FixedBuffer&& other) noexcept
+      : _io(other._io),
+        _index(std::exchange(other._index, -1)),
+        _heap(std::move(other._heap)),
+        _data(std::exchange(other._data, {})) {}
+  ~FixedBuffer() {
+    if (_index >= 0) _io->release_buffer(_index);
+  }
+
+ public:
+  // 缓冲区内存
+  [[nodiscard]]
+  std::span<std::byte> data() const {
+    return _data;
+  }
+
+  // 是否是已注册到 io_uring 的缓冲区
+  [[nodiscard]]
+  bool registered() const {
+    return _index >= 0 && _io->registered_index(_data.data(), 0) >= 0;
+  }
+
+ private:
+  FileIo* _io;
+  int _index{-1};
+  std::unique_ptr<std::byte[]> _heap{};
+  std::span<std::byte> _data{};
+};
+
+// co_await 文件读写，返回读写的字节数，失败时为 -errno
+class FileOpAwaiter {
+ public:
+  FileOpAwaiter(FileIo& io, FileOp op, bool defer_flush)
+      : _io(&io), _op(op), _defer_flush(defer_flush) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    try {
+      _io->submit(_op, [this, job = make_resume_job(handle)](
+                           std::int64_t res) {
+        _result = res;
+        job();
+      }, _defer_flush);
+    } catch (...) {
+      // 操作没有提交成功，撤销恢复任务对任务组的计数，异常在 co_await 处抛出
+      if (t_current_task_group) t_current_task_group->decrement();
+      throw;
+    }
+  }
+  std::int64_t await_resume() const noexcept { return _result; }
+
+ private:
+  FileIo* _io;
+  FileOp _op;
+  bool _defer_flush;
+  std::int64_t _result{0};
+};
+}  // namespace fastexec::detail
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef __FASTSTDEXEC_DETAIL_UTIL_HPP
 #define __FASTSTDEXEC_DETAIL_UTIL_HPP
 
+#include <cstddef>
+#include <cstdint>
+
 namespace fastexec::detail::util {
 // 非拷贝类，用于防止类被拷贝
 class noncopyable {
@@ -25,6 +28,34 @@ class Singleton {
     return instance;
   }
 };
+
+// 轻量级伪随机数生成器(xorshift64)，用于随机选择窃取目标
+class XorShift64 {
+ public:
+  // 种子先经过 splitmix64 打散，相邻的种子(如 worker id)也能得到不相关的序列
+  explicit XorShift64(std::uint64_t seed) {
+    seed += 0x9E3779B97F4A7C15ull;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+    seed ^= seed >> 31;
+    _state = seed != 0 ? seed : 0x9E3779B97F4A7C15ull;
+  }
+
+  std::uint64_t next() {
+    _state ^= _state << 13;
+    _state ^= _state >> 7;
+    _state ^= _state << 17;
+    return _state;
+  }
+
+  // 返回 [0, bound) 范围内的随机数
+  std::size_t next_below(std::size_t bound) {
+    return static_cast<std::size_t>(next() % bound);
+  }
+
+ private:
+  std::uint64_t _state;
+};
 }  // namespace fastexec::detail::util
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef __FASTSTDEXEC_DETAIL_WAITER_HPP
+#define __FASTSTDEXEC_DETAIL_WAITER_HPP
+
+#include <coroutine>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "coro.hpp"
+#include "worker.hpp"
+namespace fastexec::detail {
+// 挂起等待的协程：记录挂起时所在的线程池，被唤醒时把恢复任务交回该线程池，
+// 等待期间只占用协程帧，不占用 worker 线程
+// 唤醒方是同一线程池的 worker 时放入它的本地队列，否则放入全局队列并唤醒一个
+// 空闲 worker；线程池已关闭或挂起时不在 worker 上，则直接在唤醒方线程恢复
+class Parked {
+ public:
+  Parked() = default;
+  explicit Parked(std::coroutine_handle<> handle)
+      : _job(make_resume_job(handle)), _scheduler(t_scheduler) {}
+
+ public:
+  // 唤醒挂起的协程，只能调用一次
+  // 恢复任务交出后协程可能立即恢复并销毁自己，之后不能再访问成员
+  void wake() {
+    auto job = std::exchange(_job, nullptr);
+    auto scheduler = _scheduler;
+    if (scheduler == nullptr) {
+      job();
+      return;
+    }
+    try {
+      scheduler->resume(job);
+    } catch (const std::runtime_error&) {
+      job();
+    }
+  }
+
+  // 放弃挂起(在创建它的线程上调用)：撤销恢复任务对当前任务组的计数
+  void cancel() {
+    _job = nullptr;
+    if (t_current_task_group) t_current_task_group->decrement();
+  }
+
+ private:
+  std::function<void()> _job{};    // 恢复任务
+  Scheduler* _scheduler{nullptr};  // 挂起时所在线程池的调度接口
+};
+
+// 消耗一个单位的调度预算，预算耗尽时返回 true，调用方应当挂起并让出 worker
+inline bool budget_exhausted() {
+  if (t_task_budget == 0) return true;
+  --t_task_budget;
+  return false;
+}
+
+// 让出 worker：把协程重新排到当前 worker 本地队列的末尾，返回是否挂起
+// 不在 worker 线程上时不挂起，只重置预算
+inline bool yield_to_scheduler(std::coroutine_handle<> handle) {
+  if (t_scheduler == nullptr) {
+    t_task_budget = TASK_BUDGET;
+    return false;
+  }
+  Parked{handle}.wake();
+  return true;
+}
+
+// co_await yield_now()：让出 worker，让排在后面的任务先执行
+class YieldAwaiter {
+ public:
+  bool await_ready() const noexcept { return t_scheduler == nullptr; }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    return yield_to_scheduler(handle);
+  }
+  void await_resume() const noexcept {}
+};
+}  // namespace fastexec::detail
+
+#endif
@@ -1,117 +1,371 @@
 #ifndef __FASTSTDEXEC_DETAIL_WORKER_HPP
 #define __FASTSTDEXEC_DETAIL_WORKER_HPP
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <span>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "options.hpp"
+#include "priority.hpp"
 #include "queue.hpp"
 #include "shared.hpp"
+#include "timer.hpp"
+#include "uring.hpp"
 namespace fastexec::detail {
+template <typename Policy>
 class Worker;
-// 线程局部存储，当前worker指针
-static inline thread_local Worker* t_worker{nullptr};
+// 线程局部存储，当前worker指针(每种调度策略一个)
+template <typename Policy>
+static inline thread_local Worker<Policy>* t_worker{nullptr};
+
+template <typename Policy>
 class Worker {
-  friend class Shared;
+  friend class Shared<Policy>;
 
  public:
-  Worker(Shared* shared, std::size_t worker_id)
-      : _shared(shared), _worker_id(worker_id) {
+  Worker(Shared<Policy>* shared, std::size_t worker_id,
+         const PoolOptions& options)
+      : _worker_id(worker_id),
+        _local_queues(make_local_queues(options.queue_capacity,
+                                        options.max_queue_capacity)),
+        _shared(shared),
+        _inbox(&shared->inbox(worker_id)),
+        _node(shared->worker_node(worker_id)),
+        _idle(options.idle) {
     // 将自己注册到共享类中
     _shared->register_worker(worker_id, this);
-    t_worker = this;
-  }
-
-  ~Worker() {
-    t_worker = nullptr;
-    t_shared = nullptr;
-    _shared->_stop_latch.arrive_and_wait();
   }
 
  public:
-  // worker运行函数
+  // worker运行函数，一直运行到线程池关闭，或者被要求退役
+  // 退役后 worker 对象保留，槽位重新启动时在新的线程上再次运行
   void run() {
+    t_worker<Policy> = this;
+    t_scheduler = _shared;
+    t_worker_id = _worker_id;
+    open_inbox();
+    _shutdown = false;
+    _idling = false;
+    _active.store(true, std::memory_order::release);
+    _shared->reactivate();
+    std::size_t idle_rounds = 0;
+    std::size_t poll_rounds = 0;
     while (true) {
+      // 被要求退役时把任务交还给线程池后退出
+      if (_retire_requested.load(std::memory_order::relaxed) && retire()) {
+        break;
+      }
+      // 忙碌时每执行 POLL_INTERVAL 个任务检查一次定时器和 fd 就绪
+      if (++poll_rounds >= POLL_INTERVAL) {
+        poll_rounds = 0;
+        poll_timers();
+        poll_reactor();
+        sample_load();
+      }
       // 循环退出条件是：线程池停止且本地队列和全局队列都为空
       std::optional<std::function<void()>> task;
       // 从队列获取任务
       task = std::move(get_next_task());
       if (task.has_value()) {
-        (*task)();
+        idle_rounds = 0;
+        _idling = false;
+        run_task(*task);
         continue;
       }
       //  从其他worker的队列窃取任务
       task = std::move(task_steal());
       if (task.has_value()) {
-        (*task)();
+        idle_rounds = 0;
+        _idling = false;
+        run_task(*task);
         continue;
       }
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      // std::this_thread::sleep_for(std::chrono::milliseconds(100));//用于valgrind检查
-      _shutdown = _shared->get_global_queue().closed();
+      // 空闲时检查定时器和 fd 就绪，有到期或就绪的回调就回到循环执行它们
+      if (poll_timers() || poll_reactor()) {
+        continue;
+      }
+      // 按空闲策略先让出 CPU 重试几轮，再进入休眠
+      if (idle_rounds < _idle.spin_rounds) {
+        ++idle_rounds;
+        std::this_thread::yield();
+        continue;
+      }
+      // 连续空闲足够久时停用，直到被重新启用
+      if (should_deactivate() && _shared->try_deactivate()) {
+        deactivate();
+      } else {
+        // 有未到期的定时器时，最多休眠到下一个定时器到期
+        auto timeout = _idle.park_timeout;
+        if (auto expiry = next_timer_expiry()) {
+          timeout = std::min(timeout, until(*expiry));
+        }
+        park(timeout);
+      }
+      // park(std::chrono::milliseconds(100));//用于valgrind检查
+      _shutdown = _shared->global_queue_closed();
       if (quit_condition(_shutdown)) {
         break;
       }
     }
+    // 退出后不再取收件箱，之后放入的任务由放入的线程转移，
+    // 退出前最后一次检查之后放入的任务在这里执行完
+    std::vector<std::function<void()>> late;
+    close_inbox(late);
+    for (auto& task : late) {
+      run_task(task);
+    }
+    // 线程池关闭前没有来得及执行的退役请求作废，槽位重新启动时不再退役
+    _retire_requested.store(false, std::memory_order::relaxed);
+    _active.store(false, std::memory_order::release);
+    _shared->mark_inactive();
+    t_worker<Policy> = nullptr;
+    t_scheduler = nullptr;
+  }
+
+  // 要求 worker 退役，它在休眠或停用时唤醒它
+  void request_retire() {
+    _retire_requested.store(true, std::memory_order::release);
+    unpark();
+  }
+
+  // 撤销 worker 还没有开始执行的退役请求，返回是否撤销成功
+  bool cancel_retire() {
+    return _retire_requested.exchange(false, std::memory_order::acq_rel);
+  }
+
+  // 放入收件箱之后调用：worker 已经退役或退出、不再取收件箱时，
+  // 把收件箱中的任务转移到本节点的全局队列，线程池已关闭时丢弃它们
+  // (future 得到异常)，返回是否转移了；worker 还在运行时返回 false
+  // 放入先增加收件箱长度再检查标记，worker 先置上标记再检查长度(都是 seq_cst)，
+  // 两者至少有一方看到对方，任务不会留在没有消费者的收件箱中
+  bool forward_closed_inbox() {
+    if (!_inbox_closed.load(std::memory_order::seq_cst)) {
+      return false;
+    }
+    std::vector<std::function<void()>> tasks;
+    {
+      std::lock_guard lock{_inbox_mutex};
+      // 槽位已经重新启动，由 worker 自己取出
+      if (!_inbox_closed.load(std::memory_order::relaxed)) {
+        return false;
+      }
+      drain_inbox(tasks);
+    }
+    if (tasks.empty()) {
+      return true;
+    }
+    try {
+      _shared->get_global_queue(_node, level_of(Priority::normal))
+          .push_back_batch(tasks);
+      _shared->notify_workers(tasks.size());
+    } catch (const std::runtime_error&) {
+      for (auto& task : tasks) {
+        discard_task(task);
+      }
+    }
+    return true;
   }
 
  public:
-  // 检查本地队列是否为空
-  bool is_local_queue_empty() { return _local_queue.empty(); }
+  // 检查各优先级的本地队列是否都为空
+  bool is_local_queue_empty() {
+    return std::ranges::all_of(_local_queues,
+                               [](auto& queue) { return queue.empty(); });
+  }
 
   // 获取本地队列总大小
-  std::size_t get_local_queue_size() { return _local_queue.size(); }
+  std::size_t get_local_queue_size() {
+    std::size_t size = 0;
+    for (auto& queue : _local_queues) {
+      size += queue.size();
+    }
+    return size;
+  }
 
-  // 向本地队列推送任务，处理溢出
+  // 向指定优先级的本地队列推送任务，溢出时转移到本节点同优先级的全局队列
   bool push_back_task_to_local(std::function<void()> task,
-                               GlobalQueue& global_queue) {
-    _local_queue.push_back(std::move(task), global_queue);
+                               Priority priority = Priority::normal) {
+    auto level = level_of(priority);
+    _local_queues[level].push_back(std::move(task),
+                                   _shared->get_global_queue(_node, level));
+    _shared->mark_worker_has_task(_worker_id);
     return true;
   }
 
-  // 向本地队列推送批量任务，是否溢出通过返回值判断
-  bool push_back_batch_task_to_local(std::vector<std::function<void()>> tasks) {
-    _local_queue.push_back_batch(tasks);
+  // 本地队列已满(且不能扩容)、本节点的全局队列放不下溢出的任务时返回 false，
+  // 此时新任务需要按溢出策略处理
+  [[nodiscard]]
+  bool can_push_back_task_to_local(Priority priority) {
+    auto level = level_of(priority);
+    auto& local_queue = _local_queues[level];
+    return local_queue.remain_size() > 0 ||
+           local_queue.capacity() < local_queue.max_capacity() ||
+           _shared->get_global_queue(_node, level)
+               .has_room(local_queue.capacity() / 2 + 1);
+  }
+
+  // 向普通优先级的本地队列推送批量任务，
+  // 本地队列放不下的部分一次性提交到本节点的全局队列(按溢出策略处理)
+  bool push_back_batch_task_to_local(std::span<std::function<void()>> tasks) {
+    auto level = level_of(Priority::normal);
+    auto& local_queue = _local_queues[level];
+    if (local_queue.remain_size() < tasks.size()) {
+      local_queue.try_grow(tasks.size());
+    }
+    auto local_num = std::min(tasks.size(), local_queue.remain_size());
+    if (local_num > 0) {
+      local_queue.push_back_batch(tasks.first(local_num));
+      _shared->mark_worker_has_task(_worker_id);
+    }
+    if (local_num < tasks.size()) {
+      _shared->admit_batch_task(_shared->get_global_queue(_node, level),
+                                tasks.subspan(local_num), false);
+    }
     return true;
   }
+  // 向本地截止时间队列推送任务
+  void push_deadline_task_to_local(deadline_clock::time_point deadline,
+                                   std::function<void()> task) {
+    _deadline_queue.push(deadline, std::move(task));
+    _shared->increment_deadline_task_count();
+  }
+
   // 检查worker是否有任务
-  bool is_worker_has_task() { return !_local_queue.empty(); }
+  bool is_worker_has_task() {
+    return !is_local_queue_empty() || !_deadline_queue.empty() ||
+           !_inbox->empty();
+  }
 
   // 获取worker id
   std::size_t get_worker_id() const { return _worker_id; }
 
- private:
-  // 从本地队列获取任务，先从高优先级队列获取，再从普通优先级队列获取
-  std::optional<std::function<void()>> get_next_local_task() {
-    if (!_local_queue.empty()) {
-      return _local_queue.try_pop();
-    } else {
-      return std::nullopt;
+  // worker 是否活跃(没有因为动态伸缩而停用)
+  bool is_active() const { return _active.load(std::memory_order::acquire); }
+
+  // 判断worker是否属于指定线程池的共享状态
+  bool belongs_to(const Shared<Policy>* shared) const {
+    return _shared == shared;
+  }
+
+  // 获取worker所属线程池的共享状态
+  Shared<Policy>* get_shared() const { return _shared; }
+
+  // 获取worker所在的NUMA节点下标
+  std::size_t get_numa_node() const { return _node; }
+
+  // 唤醒处于休眠状态的worker，返回是否真正唤醒了它
+  bool unpark() {
+    if (!claim()) {
+      return false;
+    }
+    wake();
+    return true;
+  }
+
+  // 清除休眠标记，返回 worker 是否正在休眠
+  // 成功后 worker 一直等到 wake 才会醒来，调用者可以先给它准备好任务
+  bool claim() { return _parked.exchange(false, std::memory_order::seq_cst); }
+
+  // 唤醒 claim 成功的 worker
+  void wake() {
+    _park_sem.release();
+    if (_in_reactor.load(std::memory_order::relaxed)) {
+      _shared->reactor().wake();
     }
   }
 
-  // worker获取下一个任务，策略是本地队列优先,本地没有任务时从全局队列拿,返回空
+ private:
+  // worker获取下一个任务：按优先级从高到低，每一级先取本地队列，
+  // 本地没有时从本节点同优先级的全局队列批量拿，都没有返回空
+  // 饥饿保护：连续按优先级取到 STARVATION_LIMIT 个任务后，
+  // 下一次从低优先级开始取，保证后台任务不会被无限期推迟
+  // 公平性：每取 global_queue_interval 个任务先检查一次收件箱和本节点的
+  // 全局队列，本地任务不断派生新任务时，外部提交的任务的排队时间也有上限
+  // 收件箱中的任务只能由本 worker 执行，各优先级队列都为空时、窃取之前取出
   std::optional<std::function<void()>> get_next_task() {
-    std::optional<std::function<void()>> result{std::nullopt};
+    // 截止时间任务优先于所有优先级队列
+    if (_shared->has_deadline_tasks()) {
+      auto task = get_next_deadline_task();
+      if (task.has_value()) {
+        return task;
+      }
+    }
+    if (++_global_tick >= Policy::global_queue_interval) {
+      _global_tick = 0;
+      auto task = _inbox->try_pop();
+      if (task.has_value()) {
+        return task;
+      }
+      task = _shared->get_next_global_task(_node);
+      if (task.has_value()) {
+        return task;
+      }
+    }
+    bool reverse = _pick_count >= STARVATION_LIMIT;
+    for (std::size_t i = 0; i < PRIORITY_LEVELS; ++i) {
+      auto level = reverse ? PRIORITY_LEVELS - 1 - i : i;
+      auto task = get_next_task(level);
+      if (task.has_value()) {
+        _pick_count = reverse ? 0 : _pick_count + 1;
+        return task;
+      }
+    }
+    // 各优先级的本地队列都已空，清除位图中的有任务标记
+    _shared->clear_worker_has_task(_worker_id);
+    return _inbox->try_pop();
+  }
+
+  // 获取截止时间最早的任务：比较本地截止时间队列和全局截止时间队列的堆顶，
+  // 从更早到期的那个取，取不到再试另一个
+  std::optional<std::function<void()>> get_next_deadline_task() {
+    auto& global = _shared->get_global_deadline_queue();
+    DeadlineQueue* queues[] = {&_deadline_queue, &global};
+    if (global.earliest() < _deadline_queue.earliest()) {
+      std::swap(queues[0], queues[1]);
+    }
+    for (auto queue : queues) {
+      if (queue->empty()) continue;
+      auto task = queue->try_pop();
+      if (task.has_value()) {
+        _shared->decrement_deadline_task_count();
+        return task;
+      }
+    }
+    return std::nullopt;
+  }
 
+  // 获取指定优先级的下一个任务，策略是本地队列优先,本地没有任务时从全局队列拿
+  std::optional<std::function<void()>> get_next_task(std::size_t level) {
+    auto& local_queue = _local_queues[level];
     // 先从本地取
-    result = std::move(get_next_local_task());
-    if (result.has_value()) {
-      return result;
+    if (!local_queue.empty()) {
+      auto result = local_queue.try_pop();
+      if (result.has_value()) {
+        return result;
+      }
     }
-    // 如果全局队列为空，返回空
-    if (_shared->is_global_queue_empty()) {
+    // 如果本节点的全局队列为空，返回空(其他节点的全局队列在窃取阶段获取)
+    if (_shared->is_global_queue_empty(_node, level)) {
       return std::nullopt;
     }
 
-    // 获取到本地队列剩余大小的一半和容量一半的较小的那个
-    auto num =
-        std::min(_local_queue.remain_size(), _local_queue.capacity() / 2);
+    // 获取到本地队列剩余大小和调度策略规定的批量大小中较小的那个
+    auto num = std::min(local_queue.remain_size(),
+                        local_queue.capacity() / Policy::global_batch_divisor);
     if (num == 0) {
       return std::nullopt;
     }
     // 从全局队列获取num个任务
-    auto tasks = _shared->get_batch_global_tasks(num);
+    auto tasks = _shared->get_batch_global_tasks(_node, level, num);
     if (tasks.has_value() && !tasks.value().empty()) {
       auto& task_vec = tasks.value();
       // 从全局队列获取的任务中拿到最后一个任务
@@ -120,7 +374,8 @@ class Worker {
       task_vec.pop_back();
       // 如果全局队列中还有任务，把它们放到本地队列中
       if (!task_vec.empty()) {
-        _local_queue.push_back_batch(task_vec);
+        local_queue.push_back_batch(task_vec);
+        _shared->mark_worker_has_task(_worker_id);
       }
       return task;
     } else {
@@ -128,45 +383,385 @@ class Worker {
     }
   }
 
-  // 任务窃取逻辑，取本地队列中剩余任务最多的worker
+  // 当前worker被thief窃取：按优先级从高到低，
+  // 把第一个非空的本地队列中一半的任务转移到thief同优先级的本地队列
+  std::optional<std::function<void()>> be_stolen_by(Worker& thief) {
+    for (std::size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+      if (_local_queues[level].empty()) continue;
+      auto res = _local_queues[level].be_stolen_by(thief._local_queues[level]);
+      if (res.has_value()) {
+        return res;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // 任务窃取逻辑：按窃取域由近到远(SMT 兄弟、共享 L3、同一节点)选择窃取目标，
+  // 本节点内都窃取不到时先取其他节点的全局队列，最后才跨节点窃取
+  // 同时窃取的 worker 数达到上限时仍然取其他节点的全局队列：外部线程提交到
+  // 所在节点的任务可能只有其他节点的 worker 能执行(例如该节点的 worker 已退役)
   std::optional<std::function<void()>> task_steal() {
     // 先判断能不能窃取
     if (!_shared->can_steal_task()) {
-      return std::nullopt;
+      return _shared->get_next_remote_global_task(_node);
     }
     // 增加窃取worker计数
     _shared->increment_steal_worker_count();
-    // 设置正在窃取任务标志
-    _is_stealing.store(true, std::memory_order::release);
-    auto workers = _shared->get_workers();
-    std::size_t num = 0, idx = 0;
-    for (auto& worker : workers) {
-      // 不窃取自己的任务
-      if (worker == t_worker) continue;
-      if (worker->get_local_queue_size() > num &&
-          !worker->_is_stealing.load(std::memory_order::acquire)) {
-        num = worker->get_local_queue_size();
-        idx = worker->get_worker_id();
-      }
-    }
-    // 如果找到窃取目标，窃取任务
-    if (num > 0) {
-      auto res =
-          workers[idx]->_local_queue.be_stolen_by(t_worker->_local_queue);
-      _shared->decrement_steal_worker_count();
-      _is_stealing.store(false, std::memory_order::release);
-      return res;
+    auto& domains = _shared->steal_domains(_worker_id);
+    std::size_t attempts = 0;
+    std::optional<std::function<void()>> res{std::nullopt};
+    // 截止时间任务不考虑距离，直接窃取截止时间最早的那个
+    if (_shared->has_deadline_tasks()) {
+      res = steal_nearest_deadline_task();
+    }
+    for (auto& domain : domains._near) {
+      if (res.has_value()) break;
+      res = steal_from_domain(domain, attempts);
+    }
+    // 如果本节点没有窃取目标，从全局队列中获取任务，先本节点再其他节点
+    if (!res.has_value()) {
+      res = _shared->get_next_global_task(_node);
+    }
+    if (!res.has_value()) {
+      res = _shared->get_next_remote_global_task(_node);
+    }
+    if (!res.has_value() && !domains._remote.empty()) {
+      res = steal_from_domain(domains._remote, attempts);
+    }
+    _shared->decrement_steal_worker_count();
+    return res;
+  }
+
+  // 窃取所有 worker 的截止时间队列中最早到期的任务
+  // 只读取各队列发布的堆顶截止时间，选中目标后才加锁弹出
+  std::optional<std::function<void()>> steal_nearest_deadline_task() {
+    Worker* victim = nullptr;
+    auto earliest = DeadlineQueue::NO_DEADLINE;
+    for (std::size_t i = 0; i < _shared->total_worker_count(); ++i) {
+      auto worker = _shared->get_worker(i);
+      if (worker == nullptr || worker == this) continue;
+      auto deadline = worker->_deadline_queue.earliest();
+      if (deadline < earliest) {
+        earliest = deadline;
+        victim = worker;
+      }
+    }
+    if (victim == nullptr) {
+      return std::nullopt;
+    }
+    auto task = victim->_deadline_queue.try_pop();
+    if (task.has_value()) {
+      _shared->decrement_deadline_task_count();
+    }
+    return task;
+  }
+
+  // 在一个窃取域内窃取任务：从随机位置开始，借助共享的有任务位图选择目标
+  // 只读取位图，不遍历各个worker的队列，多个窃取者也会分散到不同目标
+  // attempts 记录本轮已经尝试过的目标数量
+  std::optional<std::function<void()>> steal_from_domain(
+      std::span<const std::uint64_t> domain, std::size_t& attempts) {
+    auto worker_num = _shared->total_worker_count();
+    auto start = _rng.next_below(worker_num);
+    while (attempts < MAX_STEAL_ATTEMPTS) {
+      auto victim = _shared->next_busy_worker(start, _worker_id, domain);
+      if (!victim.has_value()) {
+        break;
+      }
+      ++attempts;
+      auto res = _shared->get_worker(*victim)->be_stolen_by(*this);
+      if (res.has_value()) {
+        // 窃取到的其余任务已经放入本地队列
+        if (!is_local_queue_empty()) {
+          _shared->mark_worker_has_task(_worker_id);
+        }
+        return res;
+      }
+      // 目标已被其他线程窃取空，换下一个有任务的worker
+      start = (*victim + 1) % worker_num;
+    }
+    return std::nullopt;
+  }
+
+  // 执行任务，任务中准备好的文件 I/O 操作在任务结束后一次性提交给内核
+  // 线程池放弃排队中的任务时不执行，它的 future 得到异常
+  void run_task(std::function<void()>& task) {
+    if (_shared->aborting()) [[unlikely]] {
+      discard_task(task);
+      return;
+    }
+    t_task_budget = TASK_BUDGET;
+    task();
+    if (t_uring_flush != nullptr) {
+      std::exchange(t_uring_flush, nullptr)->flush();
+    }
+  }
+
+  // 推进本 worker 的时间轮，把到期定时器的回调作为任务放入本地队列
+  // 0 号 worker 不会退役，由它代为推进已经退役的 worker 的时间轮
+  // 线程池放弃排队中的任务时不再推进，返回是否有定时器到期
+  bool poll_timers() {
+    if (_shared->aborting()) {
+      return false;
+    }
+    bool fired = poll_timer_wheel(_shared->timer_wheel(_worker_id));
+    if (_worker_id == 0) {
+      for (auto i = _shared->worker_limit(); i < _shared->total_worker_count();
+           ++i) {
+        fired = poll_timer_wheel(_shared->timer_wheel(i)) || fired;
+      }
+    }
+    return fired;
+  }
+
+  // 本 worker 负责推进的时间轮中最早需要推进的时间，没有定时器时返回空
+  std::optional<deadline_clock::time_point> next_timer_expiry() {
+    auto next = _shared->timer_wheel(_worker_id).next_expiry();
+    if (_worker_id != 0) {
+      return next;
+    }
+    for (auto i = _shared->worker_limit(); i < _shared->total_worker_count();
+         ++i) {
+      auto expiry = _shared->timer_wheel(i).next_expiry();
+      if (expiry && (!next || *expiry < *next)) {
+        next = expiry;
+      }
+    }
+    return next;
+  }
+
+  // 距离 time 的时间，向上取整，已经过去时为 0
+  static std::chrono::microseconds until(deadline_clock::time_point time) {
+    auto now = deadline_clock::now();
+    if (time <= now) {
+      return std::chrono::microseconds::zero();
+    }
+    return std::chrono::ceil<std::chrono::microseconds>(time - now);
+  }
+
+  // 推进一个时间轮，返回是否有定时器到期
+  bool poll_timer_wheel(TimerWheel& wheel) {
+    if (wheel.empty()) {
+      return false;
+    }
+    wheel.advance(deadline_clock::now(), _expired_timers);
+    if (_expired_timers.empty()) {
+      return false;
+    }
+    // 被丢弃的到期任务不执行回调(周期定时器下次照常到期)
+    for (auto& entry : _expired_timers) {
+      push_back_task_to_local([entry = std::move(entry)]() {
+        if (t_discard_task) {
+          entry->skip();
+        } else {
+          entry->fire();
+        }
+      });
+    }
+    _expired_timers.clear();
+    return true;
+  }
+
+  // 不阻塞地检查一次 fd 就绪(已经有其他 worker 在驱动 reactor 时跳过)，
+  // 就绪的回调作为任务放入本地队列，返回是否有回调就绪
+  bool poll_reactor() {
+    auto& reactor = _shared->reactor();
+    if (!reactor.has_waiters() || !reactor.try_begin_poll()) {
+      return false;
+    }
+    reactor.poll(std::chrono::microseconds::zero(), _ready_io);
+    reactor.end_poll();
+    return dispatch_ready_io();
+  }
+
+  // 把就绪的回调作为任务放入本地队列
+  bool dispatch_ready_io() {
+    if (_ready_io.empty()) {
+      return false;
+    }
+    for (auto& callback : _ready_io) {
+      push_back_task_to_local(std::move(callback));
+    }
+    _ready_io.clear();
+    return true;
+  }
+
+  // 空闲休眠，最多休眠 timeout，期间可以被 unpark 提前唤醒
+  // 有 fd 在等待就绪时，由一个空闲 worker 代替休眠阻塞在 epoll_wait 上，
+  // unpark 通过 eventfd 唤醒它
+  template <typename Rep, typename Period>
+  void park(std::chrono::duration<Rep, Period> timeout) {
+    auto& reactor = _shared->reactor();
+    if (reactor.has_waiters() && reactor.try_begin_poll()) {
+      // 先标记正在驱动 reactor 再标记休眠，unpark 看到休眠标记时
+      // 一定也能看到前者，从而写 eventfd 唤醒 epoll_wait
+      _in_reactor.store(true, std::memory_order::relaxed);
+      _parked.store(true, std::memory_order::seq_cst);
+      _shared->push_idle_worker(_worker_id);
+      // 休眠标记之后收件箱不为空时只检查一次 fd 就绪，不阻塞
+      auto wait = _inbox->empty()
+                      ? std::chrono::duration_cast<std::chrono::microseconds>(
+                            timeout)
+                      : std::chrono::microseconds::zero();
+      reactor.poll(wait, _ready_io);
+      _in_reactor.store(false, std::memory_order::relaxed);
+      if (!_parked.exchange(false, std::memory_order::acq_rel)) {
+        // 有其他线程抢先唤醒了我们，取走它即将释放的信号
+        _park_sem.acquire();
+      }
+      reactor.end_poll();
+      dispatch_ready_io();
+      return;
+    }
+    _parked.store(true, std::memory_order::seq_cst);
+    _shared->push_idle_worker(_worker_id);
+    // 收件箱的任务只有本 worker 能执行：放入任务的线程先放入再检查休眠标记，
+    // 这里先设置休眠标记再检查收件箱(都是 seq_cst)，两者至少有一方看到对方
+    if (!_inbox->empty()) {
+      if (!_parked.exchange(false, std::memory_order::acq_rel)) {
+        _park_sem.acquire();
+      }
+      return;
+    }
+    if (!_park_sem.try_acquire_for(timeout) &&
+        !_parked.exchange(false, std::memory_order::acq_rel)) {
+      // 超时的同时有其他线程抢先唤醒了我们，取走它即将释放的信号，
+      // 保证信号量的计数不会超过 1
+      _park_sem.acquire();
+    }
+  }
+
+  // 忙碌时采样负载：连续 SCALE_UP_SAMPLES 次采样都有积压时启用一个停用的 worker
+  void sample_load() {
+    if (!_shared->is_backlogged(get_local_queue_size())) {
+      _backlog_samples = 0;
+      return;
+    }
+    if (++_backlog_samples >= SCALE_UP_SAMPLES) {
+      _backlog_samples = 0;
+      _shared->activate_worker();
+    }
+  }
+
+  // 开启了动态伸缩、连续空闲超过 idle_timeout 时可以停用
+  // 时间轮中的定时器不阻止停用，停用后休眠到下一个定时器到期
+  bool should_deactivate() {
+    if (!_shared->scaling_enabled() || _shared->global_queue_closed()) {
+      return false;
+    }
+    auto now = deadline_clock::now();
+    if (!_idling) {
+      _idling = true;
+      _idle_since = now;
+      return false;
+    }
+    return now - _idle_since >= _shared->scaling().idle_timeout;
+  }
+
+  // 停用：不登记为空闲 worker，也不驱动 reactor，休眠到负责推进的时间轮中
+  // 下一个定时器到期(没有定时器时不设超时)，或者放入收件箱、插入定时器、
+  // 积压时启用、线程池关闭时被 unpark 唤醒
+  // 只是定时器到期时仍然算作空闲，处理完到期的定时器后直接再次停用
+  void deactivate() {
+    _active.store(false, std::memory_order::seq_cst);
+    _parked.store(true, std::memory_order::seq_cst);
+    bool woken = true;
+    if (!_inbox->empty() || _shared->global_queue_closed()) {
+      if (!_parked.exchange(false, std::memory_order::acq_rel)) {
+        _park_sem.acquire();
+      }
+    } else if (auto expiry = next_timer_expiry()) {
+      if (!_park_sem.try_acquire_for(until(*expiry))) {
+        // 超时的同时有其他线程抢先唤醒了我们，取走它即将释放的信号
+        woken = !_parked.exchange(false, std::memory_order::acq_rel);
+        if (woken) {
+          _park_sem.acquire();
+        }
+      }
     } else {
-      // 如果没有找到窃取目标，从全局队列中获取任务
-      _shared->decrement_steal_worker_count();
-      _is_stealing.store(false, std::memory_order::release);
-      return _shared->get_next_global_task();
+      _park_sem.acquire();
+    }
+    _active.store(true, std::memory_order::release);
+    _shared->reactivate();
+    _idling = !woken;
+  }
+
+  // 退役：本地队列和收件箱中的任务转移到本节点的全局队列(收件箱中的任务
+  // 不再保证在本 worker 上执行)，截止时间队列转移到全局截止时间队列，
+  // 时间轮由 0 号 worker 推进；线程池已经关闭时在这里执行完转移不出去的任务，
+  // 不退役，照常运行到退出；请求已被撤销时返回 false
+  bool retire() {
+    if (!_retire_requested.exchange(false, std::memory_order::acq_rel)) {
+      return false;
+    }
+    bool closed = false;
+    std::size_t moved = 0;
+    std::vector<std::function<void()>> inbox;
+    close_inbox(inbox);
+    std::vector<std::function<void()>> tasks;
+    for (std::size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+      tasks.clear();
+      while (auto task = _local_queues[level].try_pop()) {
+        tasks.push_back(std::move(*task));
+      }
+      if (level == level_of(Priority::normal)) {
+        std::ranges::move(inbox, std::back_inserter(tasks));
+      }
+      if (tasks.empty()) continue;
+      try {
+        _shared->get_global_queue(_node, level).push_back_batch(tasks);
+        moved += tasks.size();
+      } catch (const std::runtime_error&) {
+        closed = true;
+        for (auto& task : tasks) {
+          run_task(task);
+        }
+      }
+    }
+    // 截止时间任务仍然计入 _deadline_task_count，转移后由其他 worker 直接取
+    moved += _deadline_queue.move_to(_shared->get_global_deadline_queue());
+    _shared->clear_worker_has_task(_worker_id);
+    _shared->notify_workers(moved);
+    // 不退役，继续取收件箱
+    if (closed) {
+      open_inbox();
+      return false;
+    }
+    // 0 号 worker 可能正停用休眠到它原来的定时器到期，唤醒它重新计算
+    if (!_shared->timer_wheel(_worker_id).empty()) {
+      _shared->get_worker(0)->unpark();
+    }
+    return true;
+  }
+
+  // 开始取收件箱(worker 开始运行时)
+  void open_inbox() {
+    std::lock_guard lock{_inbox_mutex};
+    _inbox_closed.store(false, std::memory_order::seq_cst);
+  }
+
+  // 不再取收件箱(退役或退出时)，取出其中剩余的任务
+  void close_inbox(std::vector<std::function<void()>>& tasks) {
+    std::lock_guard lock{_inbox_mutex};
+    _inbox_closed.store(true, std::memory_order::seq_cst);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    drain_inbox(tasks);
+  }
+
+  // 取出收件箱中的所有任务(调用方持有 _inbox_mutex)
+  // 已经计入长度的任务一定已经链接或正在链接，等生产者链接完成
+  void drain_inbox(std::vector<std::function<void()>>& tasks) {
+    while (!_inbox->empty()) {
+      if (auto task = _inbox->try_pop()) {
+        tasks.push_back(std::move(*task));
+      } else {
+        std::this_thread::yield();
+      }
     }
   }
 
   bool quit_condition(bool shutdown) {
-    if (shutdown && _local_queue.empty() &&
-        _shared->get_global_queue().empty()) {
+    if (shutdown && !is_worker_has_task() && _shared->is_global_queue_empty()) {
       return true;
     } else {
       return false;
@@ -174,12 +769,152 @@ class Worker {
   }
 
  private:
-  std::size_t _worker_id{};               // worker id
-  LocalQueue<> _local_queue{};            // 普通优先级队列
-  Shared* _shared{};                      // 共享类指针
-  std::atomic<bool> _is_stealing{false};  // 是否正在窃取任务
-  bool _shutdown{false};                  // 是否关闭
+  using local_queue_type =
+      LocalQueue<Policy::local_queue_capacity, Policy::steal_divisor>;
+  using local_queues_type = std::array<local_queue_type, PRIORITY_LEVELS>;
+
+  // 创建各优先级的本地队列，调度策略规定了固定容量时忽略运行时的容量配置
+  static local_queues_type make_local_queues(std::size_t capacity,
+                                             std::size_t max_capacity) {
+    if constexpr (Policy::local_queue_capacity != dynamic_capacity) {
+      (void)capacity, (void)max_capacity;
+      return local_queues_type{};
+    } else {
+      return [=]<std::size_t... I>(std::index_sequence<I...>) {
+        return local_queues_type{
+            ((void)I, local_queue_type(capacity, max_capacity))...};
+      }(std::make_index_sequence<PRIORITY_LEVELS>{});
+    }
+  }
+
+ private:
+  // 每次窃取最多尝试的目标数量
+  constexpr static inline std::size_t MAX_STEAL_ATTEMPTS = 4;
+  // 饥饿保护：连续按优先级取任务的次数上限
+  constexpr static inline std::size_t STARVATION_LIMIT = 32;
+  // 忙碌时检查定时器和 fd 就绪的间隔(任务数)
+  constexpr static inline std::size_t POLL_INTERVAL = 64;
+  // 连续多少次负载采样都有积压才启用一个停用的 worker
+  constexpr static inline std::size_t SCALE_UP_SAMPLES = 4;
+
+  std::size_t _worker_id{};            // worker id
+  local_queues_type _local_queues;     // 各优先级的本地队列
+  std::size_t _pick_count{0};          // 连续按优先级取任务的次数
+  std::size_t _global_tick{0};         // 上次检查全局队列后取任务的次数
+  DeadlineQueue _deadline_queue{};     // 截止时间队列
+  std::vector<std::shared_ptr<TimerEntry>> _expired_timers{};  // 到期定时器
+  std::vector<std::function<void()>> _ready_io{};  // 就绪的 fd 等待回调
+  Shared<Policy>* _shared{};           // 共享类指针
+  MpscQueue* _inbox{};                 // 收件箱(属于共享类)
+  std::size_t _node{};                 // 所在 NUMA 节点下标
+  IdlePolicy _idle{};                  // 空闲策略
+  bool _idling{false};                 // 是否处于连续空闲中
+  deadline_clock::time_point _idle_since{};  // 连续空闲的开始时间
+  std::size_t _backlog_samples{0};     // 连续有积压的负载采样次数
+  std::atomic<bool> _active{false};    // 是否活跃(停用、退役时为 false)
+  std::atomic<bool> _retire_requested{false};  // 是否被要求退役
+  std::mutex _inbox_mutex{};  // 收件箱没有消费者时，保证只有一个线程取出
+  std::atomic<bool> _inbox_closed{true};  // 是否不再取收件箱(未运行、退役或退出)
+  util::XorShift64 _rng{_worker_id + 1};  // 随机选择窃取目标
+  std::atomic<bool> _parked{false};      // 是否正在空闲休眠
+  std::atomic<bool> _in_reactor{false};  // 是否正在代替休眠驱动 reactor
+  std::binary_semaphore _park_sem{0};    // 休眠唤醒信号
+  bool _shutdown{false};                 // 是否关闭
 };
+
+// 唤醒最多 count 个处于休眠状态的 worker(不包括当前线程的 worker)
+// 从轮询索引开始扫描，避免每次都唤醒同一批 worker
+template <typename Policy>
+inline void Shared<Policy>::notify_workers(std::size_t count) {
+  auto worker_num = _workers.size();
+  auto start = _notify_index.fetch_add(1, std::memory_order::relaxed);
+  for (std::size_t i = 0; i < worker_num && count > 0; ++i) {
+    auto worker = get_worker((start + i) % worker_num);
+    if (worker == nullptr || worker == t_worker<Policy>) continue;
+    // 停用的 worker 只在积压时由 activate_worker 启用
+    if (!worker->is_active()) continue;
+    if (worker->unpark()) {
+      --count;
+    }
+  }
+}
+
+template <typename Policy>
+inline void Shared<Policy>::wake_all_workers() {
+  for (std::size_t i = 0; i < _workers.size(); ++i) {
+    if (auto worker = get_worker(i); worker != nullptr) {
+      worker->unpark();
+    }
+  }
+}
+
+// 从轮询索引开始在运行中的 worker 里找一个停用并且正在休眠的唤醒它
+template <typename Policy>
+inline bool Shared<Policy>::activate_worker() {
+  auto worker_num = worker_limit();
+  auto start = _notify_index.fetch_add(1, std::memory_order::relaxed);
+  for (std::size_t i = 0; i < worker_num; ++i) {
+    auto worker = get_worker((start + i) % worker_num);
+    if (worker == nullptr || worker->is_active()) continue;
+    if (worker->unpark()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 当前线程是本线程池的 worker 时放入它的本地队列，否则放入全局队列并唤醒一个
+// 空闲 worker
+template <typename Policy>
+inline void Shared<Policy>::resume(std::function<void()>& job) {
+  auto worker = t_worker<Policy>;
+  if (worker != nullptr && worker->belongs_to(this)) {
+    worker->push_back_task_to_local(std::move(job));
+    return;
+  }
+  push_back_task_to_global(job);
+  notify_workers(1);
+}
+
+// 从空闲栈弹出 worker 并确认它仍在休眠，把任务放入它的收件箱后唤醒，
+// 任务不经过全局队列的锁，也不用等 worker 休眠超时后才发现它
+// 弹出的 worker 已经醒来时换下一个，最多尝试 HANDOFF_ATTEMPTS 次；
+// 全局队列中已经有同优先级的任务在排队时不插队，线程池关闭后也不再交出，
+// 都返回 false
+template <typename Policy>
+inline bool Shared<Policy>::try_handoff(std::function<void()>& task,
+                                        Priority priority) {
+  if (_idle_workers.empty() || global_queue_closed() ||
+      !get_global_queue(caller_node(), level_of(priority)).empty()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < HANDOFF_ATTEMPTS; ++i) {
+    auto worker_id = _idle_workers.pop();
+    if (!worker_id.has_value()) {
+      return false;
+    }
+    auto worker = get_worker(*worker_id);
+    if (worker == nullptr || !worker->claim()) {
+      continue;
+    }
+    _inboxes[*worker_id]->push(std::move(task));
+    worker->wake();
+    return true;
+  }
+  return false;
+}
+
+// 收件箱不受全局队列容量限制，放入后唤醒目标 worker(它在休眠时)
+// 与退役或关闭同时发生、目标 worker 已经不再取收件箱时，转移到全局队列
+template <typename Policy>
+inline void Shared<Policy>::push_back_task_to_inbox(
+    std::size_t worker_id, std::function<void()> task) {
+  _inboxes[worker_id]->push(std::move(task));
+  if (auto worker = get_worker(worker_id);
+      worker != nullptr && !worker->forward_closed_inbox()) {
+    worker->unpark();
+  }
+}
 }  // namespace fastexec::detail
 
 #endif
\ No newline at end of file
@@ -1,13 +1,26 @@
 #ifndef __FASTEXEC_EXEC_HPP
 #define __FASTEXEC_EXEC_HPP
+#include <chrono>
+#include <concepts>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
+#include "detail/channel.hpp"
+#include "detail/local.hpp"
 #include "detail/pool.hpp"
+#include "detail/sync.hpp"
 
-// 内部创建线程池实例
+// 内部创建默认线程池实例，供外部接口的自由函数使用
 namespace fastexec::__inner {
 inline auto& _fastexec_inner_thread_pool =
-    fastexec::detail::thread_pool::instance();
+    fastexec::detail::util::Singleton<fastexec::detail::thread_pool>::instance();
 
 namespace detail {
 // 定义一个类型特征元函数
@@ -38,6 +51,9 @@ future_result_t<T> get_future_value(std::future<T>& f) {
 
 // 外部接口
 namespace fastexec {
+// 任务优先级：high、normal(默认)、background
+using priority = detail::Priority;
+
 // 非阻塞创建异步任务，返回future
 template <typename F, typename... Args>
 std::future<std::invoke_result_t<F, Args...>> spawn(F&& f, Args&&... args) {
@@ -45,12 +61,251 @@ std::future<std::invoke_result_t<F, Args...>> spawn(F&& f, Args&&... args) {
       std::forward<F>(f), std::forward<Args>(args)...);
 }
 
-// 主动关闭线程池并且等待线程回收
+// 以指定优先级非阻塞创建异步任务，返回future
+// worker 总是先执行高优先级任务，后台任务也不会被无限期推迟
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> spawn(priority p, F&& f,
+                                                    Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit(
+      p, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 创建带截止时间(steady_clock 上的绝对时间)的异步任务，返回future
+// worker 优先执行截止时间最早的任务，窃取时也优先窃取最早到期的任务
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> spawn_with_deadline(
+    std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_with_deadline(
+      deadline, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 在编号为 worker_id 的 worker 上创建异步任务，返回future
+// 任务不会被窃取，按提交顺序在该 worker 上执行，
+// 只由一个 worker 访问的分片数据不需要加锁；worker_id 越界时抛出 out_of_range
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> spawn_on(std::size_t worker_id,
+                                                       F&& f, Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_on(
+      worker_id, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 当前线程是默认线程池的 worker 时返回它的编号(0 到 worker 数 - 1)，否则返回空
+inline std::optional<std::size_t> current_worker_id() {
+  return __inner::_fastexec_inner_thread_pool.current_worker_id();
+}
+
+// 默认线程池中错过截止时间的任务数量
+inline std::size_t missed_deadlines() {
+  return __inner::_fastexec_inner_thread_pool.missed_deadlines();
+}
+
+// 全局队列满时各溢出策略生效的次数
+using overflow_counters = detail::OverflowStats;
+
+// 默认线程池的全局队列满时各溢出策略生效的次数(默认线程池不限制容量)
+inline overflow_counters overflow_stats() {
+  return __inner::_fastexec_inner_thread_pool.overflow_stats();
+}
+
+// 定时器句柄，cancel() 取消定时器
+using timer_handle = detail::TimerHandle;
+
+// 在 delay 之后执行 f(args...)，不占用 worker 等待，返回定时器句柄
+// 定时器不加入当前任务组，block_on 不会等待未到期的定时器
+template <typename Rep, typename Period, typename F, typename... Args>
+timer_handle spawn_after(std::chrono::duration<Rep, Period> delay, F&& f,
+                         Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_after(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay),
+      std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 在 when 时刻执行 f(args...)，返回定时器句柄
+template <typename F, typename... Args>
+timer_handle spawn_at(std::chrono::steady_clock::time_point when, F&& f,
+                      Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_at(
+      when, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 每隔 period 执行一次 f(args...)，直到取消或线程池关闭，返回定时器句柄
+template <typename Rep, typename Period, typename F, typename... Args>
+timer_handle spawn_every(std::chrono::duration<Rep, Period> period, F&& f,
+                         Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_every(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(period),
+      std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 协程任务类型，在协程中可以 co_await 库提供的可等待对象
+template <typename T = void>
+using task = detail::Task<T>;
+
+// 在默认线程池中执行协程任务，返回获取结果的 future
+// 协程挂起等待期间不占用 worker，block_on 会等待它完成
+template <typename T>
+std::future<T> co_spawn(task<T> t) {
+  return __inner::_fastexec_inner_thread_pool.co_spawn(std::move(t));
+}
+
+// 在协程中让出 worker：co_await fastexec::yield_now()
+// 协程重新排到当前 worker 本地队列的末尾，排在后面的任务先执行，
+// 不在 worker 线程上时立即继续
+[[nodiscard]]
+inline detail::YieldAwaiter yield_now() {
+  return {};
+}
+
+// fd 可读时执行 f(args...)(一次性)，返回future
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> on_readable(int fd, F&& f,
+                                                          Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_on_ready(
+      fd, detail::Readiness::readable, std::forward<F>(f),
+      std::forward<Args>(args)...);
+}
+
+// fd 可写时执行 f(args...)(一次性)，返回future
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> on_writable(int fd, F&& f,
+                                                          Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_on_ready(
+      fd, detail::Readiness::writable, std::forward<F>(f),
+      std::forward<Args>(args)...);
+}
+
+// 在协程中等待 fd 可读：co_await fastexec::readable(fd)
+inline auto readable(int fd) {
+  return __inner::_fastexec_inner_thread_pool.wait_ready(
+      fd, detail::Readiness::readable);
+}
+
+// 在协程中等待 fd 可写：co_await fastexec::writable(fd)
+inline auto writable(int fd) {
+  return __inner::_fastexec_inner_thread_pool.wait_ready(
+      fd, detail::Readiness::writable);
+}
+
+// 停止监听 fd 并唤醒 fd 上所有等待者，关闭 fd 之前调用
+inline void release_fd(int fd) {
+  __inner::_fastexec_inner_thread_pool.release_fd(fd);
+}
+
+// 异步有界多生产者多消费者通道：fastexec::channel<T> ch(capacity)
+// 在协程中 co_await ch.send(v) / ch.recv()，已满或为空时只挂起协程，不阻塞 worker
+template <typename T>
+using channel = detail::Channel<T>;
+
+// 一次性通道：auto [tx, rx] = fastexec::oneshot<T>()，
+// tx.send(v) 发送一次，协程中 co_await rx.recv()、普通线程中 rx.get() 接收
+template <typename T>
+using oneshot_sender = detail::OneshotSender<T>;
+template <typename T>
+using oneshot_receiver = detail::OneshotReceiver<T>;
+template <typename T>
+std::pair<oneshot_sender<T>, oneshot_receiver<T>> oneshot() {
+  return detail::make_oneshot<T>();
+}
+
+// 广播通道：每个订阅者(subscribe())都收到订阅之后发送的每个值，落后太多时跳过旧值
+template <typename T>
+using broadcast = detail::Broadcast<T>;
+
+// 观察通道：只保存最新值和版本号，co_await rx.changed() 等待值变化
+template <typename T>
+using watch = detail::Watch<T>;
+
+// 协程同步原语：等待时挂起协程而不是阻塞 worker 线程
+// co_await m.scoped_lock() / co_await sem.acquire() / co_await latch.wait()
+using async_mutex = detail::AsyncMutex;
+using async_lock_guard = detail::AsyncLockGuard;
+using async_semaphore = detail::AsyncSemaphore;
+using async_latch = detail::AsyncLatch;
+
+// 文件读写缓冲区，优先使用已注册到 io_uring 的固定缓冲区
+using io_buffer = detail::FixedBuffer;
+
+// 分配文件读写缓冲区，用它的 data() 读写时不需要内核每次锁定用户内存
+inline io_buffer acquire_buffer() {
+  return __inner::_fastexec_inner_thread_pool.acquire_buffer();
+}
+
+// 在协程中读取文件：co_await fastexec::read_at(fd, buf, offset)
+// 返回读取的字节数，失败时为 -errno；Linux 上使用 io_uring，否则在阻塞任务线程中执行
+inline auto read_at(int fd, std::span<std::byte> buf, std::uint64_t offset) {
+  return __inner::_fastexec_inner_thread_pool.read_at(fd, buf, offset);
+}
+
+// 在协程中写入文件：co_await fastexec::write_at(fd, buf, offset)
+inline auto write_at(int fd, std::span<const std::byte> buf,
+                     std::uint64_t offset) {
+  return __inner::_fastexec_inner_thread_pool.write_at(fd, buf, offset);
+}
+
+// 读取文件，完成后执行 f(读取的字节数或 -errno)，返回future
+template <typename F>
+std::future<std::invoke_result_t<F, std::int64_t>> read_at(
+    int fd, std::span<std::byte> buf, std::uint64_t offset, F&& f) {
+  return __inner::_fastexec_inner_thread_pool.read_at(fd, buf, offset,
+                                                      std::forward<F>(f));
+}
+
+// 写入文件，完成后执行 f(写入的字节数或 -errno)，返回future
+template <typename F>
+std::future<std::invoke_result_t<F, std::int64_t>> write_at(
+    int fd, std::span<const std::byte> buf, std::uint64_t offset, F&& f) {
+  return __inner::_fastexec_inner_thread_pool.write_at(fd, buf, offset,
+                                                       std::forward<F>(f));
+}
+
+// 创建会阻塞线程的异步任务(sleep、文件读写、等锁等)，返回future
+// 任务在弹性的阻塞任务线程集合中执行，不占用 worker；block_on 同样会等待它
+template <typename F, typename... Args>
+std::future<std::invoke_result_t<F, Args...>> spawn_blocking(F&& f,
+                                                             Args&&... args) {
+  return __inner::_fastexec_inner_thread_pool.submit_blocking(
+      std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+// 批量创建异步任务：对 range 中每个元素调用 f，整批任务一次入队，返回 future 数组
+// 整批任务共享同一个 f，在不同 worker 上并发调用，f 必须可以通过 const 引用调用
+// (不能是 mutable lambda 或有状态的函数对象)
+template <std::ranges::input_range R, typename F>
+  requires std::invocable<const std::decay_t<F>&,
+                          std::ranges::range_value_t<R>&>
+auto spawn_batch(R&& range, F&& f) {
+  return __inner::_fastexec_inner_thread_pool.submit_batch(
+      std::forward<R>(range), std::forward<F>(f));
+}
+
+// 批量创建 n 个异步任务：依次调用 f(0) ... f(n - 1)，返回 future 数组
+template <typename F>
+auto spawn_n(std::size_t n, F&& f) {
+  return spawn_batch(std::views::iota(std::size_t{0}, n), std::forward<F>(f));
+}
+
+// 关闭线程池时如何处理排队中的任务：drain(执行完)、abort(丢弃)
+using shutdown_mode = detail::ShutdownMode;
+
+// 主动关闭线程池并且等待线程回收(执行完排队中的任务)
 inline void close_and_join() {
-  __inner::_fastexec_inner_thread_pool.close();
-  __inner::_fastexec_inner_thread_pool.wait_for_all();
+  __inner::_fastexec_inner_thread_pool.shutdown();
+}
+
+// 按 mode 关闭默认线程池并等待线程退出，之后可以用 restart 重新启动
+inline void shutdown(shutdown_mode mode = shutdown_mode::drain) {
+  __inner::_fastexec_inner_thread_pool.shutdown(mode);
+}
+
+// 关闭默认线程池，最多等待 timeout 执行排队中的任务，超时后丢弃剩余的任务
+// 返回排队中的任务是否都执行完
+inline bool shutdown(std::chrono::milliseconds timeout) {
+  return __inner::_fastexec_inner_thread_pool.shutdown(timeout);
 }
 
+// 重新启动已经关闭的默认线程池
+inline void restart() { __inner::_fastexec_inner_thread_pool.restart(); }
+
 // 阻塞等待多个任务，返回 tuple
 template <typename... Ts>
 std::tuple<__inner::detail::future_result_t<Ts>...> wait(
@@ -61,31 +316,353 @@ std::tuple<__inner::detail::future_result_t<Ts>...> wait(
 // 阻塞一个任务，等待他及其所有子任务完成
 template <typename F, typename... Args>
 static inline void block_on(F&& f, Args&&... args) {
-  // 1. 创建一个新的任务组记分牌
-  auto group = std::make_shared<detail::TaskGroup>();
-
-  {
-    // 2. 设置当前线程的 TLS 上下文
-    // 这样做的目的是：当我们紧接着调用 submit 时，submit 能够看到这个
-    // group，从而将第一个任务关联到这个 group 中。
-    auto prev_group = detail::t_current_task_group;
-    detail::t_current_task_group = group;
-
-    // 3. 提交任务
-    // submit 内部会检测到 t_current_task_group 不为空，执行
-    // group->increment()，并将 group 打包进任务闭包。
-    __inner::_fastexec_inner_thread_pool.submit(std::forward<F>(f),
+  __inner::_fastexec_inner_thread_pool.block_on(std::forward<F>(f),
                                                 std::forward<Args>(args)...);
-    // 4. 恢复上下文
-    // 避免影响后续在本线程提交的其他无关任务
-    detail::t_current_task_group = prev_group;
+}
+
+// 线程池配置类型
+using affinity_policy = detail::AffinityPolicy;
+using idle_policy = detail::IdlePolicy;
+using scaling_policy = detail::ScalingPolicy;
+using overflow_policy = detail::OverflowPolicy;
+
+// 调度策略：编译期确定的队列容量、窃取比例、批量大小和窃取限流比例
+// 自定义策略可以继承 default_policy 并覆盖其中的常量
+using default_policy = detail::DefaultPolicy;
+using throughput_policy = detail::ThroughputPolicy;
+using latency_policy = detail::LatencyPolicy;
+
+template <detail::SchedulerPolicy Policy>
+class basic_runtime;
+using runtime = basic_runtime<default_policy>;
+
+// runtime 构建器，未设置的配置项使用默认值(与默认线程池相同)
+class runtime_builder {
+ public:
+  // 工作线程数，默认为进程可以使用的 CPU 数(亲和性掩码，并受 cgroup 配额限制)
+  runtime_builder& worker_threads(std::size_t n) {
+    _options.thread_num = n;
+    return *this;
+  }
+  // resize 可以调整到的最大工作线程数，默认为工作线程数和硬件并发度中较大的那个
+  runtime_builder& max_worker_threads(std::size_t n) {
+    _options.max_thread_num = n;
+    return *this;
+  }
+  // 每个 worker 本地队列的容量，向上取整到 2 的幂，默认 256
+  runtime_builder& queue_capacity(std::size_t n) {
+    _options.queue_capacity = n;
+    return *this;
+  }
+  // 本地队列满时可以扩容到的最大容量，默认不扩容(满时一半任务转移到全局队列)
+  runtime_builder& max_queue_capacity(std::size_t n) {
+    _options.max_queue_capacity = n;
+    return *this;
+  }
+  // 空闲策略：休眠前的重试轮数和单次休眠的最长时间
+  runtime_builder& idle(idle_policy policy) {
+    _options.idle = policy;
+    return *this;
+  }
+  // 动态伸缩策略：最少活跃 worker 数、积压阈值和停用前的空闲时间，默认不伸缩
+  runtime_builder& scaling(scaling_policy policy) {
+    _options.scaling = policy;
+    return *this;
+  }
+  // CPU 亲和性策略，list 策略需要给出 CPU 列表(为空时警告并按 compact 绑定)
+  runtime_builder& affinity(affinity_policy policy,
+                            std::vector<int> cpu_list = {}) {
+    _options.affinity = policy;
+    _options.cpu_list = std::move(cpu_list);
+    return *this;
+  }
+  // 线程名前缀，线程名为 "<前缀>-w<id>"(阻塞任务线程为 "<前缀>-b<id>")
+  runtime_builder& thread_name(std::string prefix) {
+    _options.thread_name = std::move(prefix);
+    return *this;
+  }
+  // 阻塞任务线程数上限，默认 512
+  runtime_builder& max_blocking_threads(std::size_t n) {
+    _options.max_blocking_threads = n;
+    return *this;
+  }
+  // 阻塞任务线程空闲多久后退出，默认 10 秒
+  runtime_builder& blocking_keep_alive(std::chrono::milliseconds keep_alive) {
+    _options.blocking_keep_alive = keep_alive;
+    return *this;
+  }
+  // 每个全局队列的容量，默认 0 表示不限制
+  runtime_builder& global_queue_capacity(std::size_t n) {
+    _options.global_queue_capacity = n;
+    return *this;
+  }
+  // 全局队列满时新任务的处理策略，默认 block
+  runtime_builder& overflow_policy(fastexec::overflow_policy policy) {
+    _options.overflow_policy = policy;
+    return *this;
+  }
+
+  // 创建 runtime 并启动其工作线程，Policy 为编译期的调度策略
+  template <detail::SchedulerPolicy Policy = default_policy>
+  basic_runtime<Policy> build() const;
+
+ private:
+  detail::PoolOptions _options{};
+};
+
+// 独立的线程池实例，拥有自己的工作线程、队列和配置
+// 接口与默认线程池的自由函数一一对应，析构时关闭并等待工作线程退出
+template <detail::SchedulerPolicy Policy = default_policy>
+class basic_runtime {
+  friend class runtime_builder;
+  template <typename T>
+  friend class worker_local;
+
+ public:
+  static runtime_builder builder() { return runtime_builder{}; }
+
+  // 非阻塞创建异步任务，返回future
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> spawn(F&& f, Args&&... args) {
+    return _pool->submit(std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 以指定优先级非阻塞创建异步任务，返回future
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> spawn(priority p, F&& f,
+                                                      Args&&... args) {
+    return _pool->submit(p, std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 创建带截止时间的异步任务，worker 优先执行截止时间最早的任务
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> spawn_with_deadline(
+      std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args) {
+    return _pool->submit_with_deadline(deadline, std::forward<F>(f),
+                                       std::forward<Args>(args)...);
+  }
+
+  // 在编号为 worker_id 的 worker 上创建异步任务，任务不会被窃取
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> spawn_on(std::size_t worker_id,
+                                                         F&& f,
+                                                         Args&&... args) {
+    return _pool->submit_on(worker_id, std::forward<F>(f),
+                            std::forward<Args>(args)...);
+  }
+
+  // 当前线程是本实例的 worker 时返回它的编号，否则返回空
+  [[nodiscard]]
+  std::optional<std::size_t> current_worker_id() const {
+    return _pool->current_worker_id();
+  }
+
+  // 在 delay 之后执行 f(args...)，返回定时器句柄
+  template <typename Rep, typename Period, typename F, typename... Args>
+  timer_handle spawn_after(std::chrono::duration<Rep, Period> delay, F&& f,
+                           Args&&... args) {
+    return _pool->submit_after(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay),
+        std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 在 when 时刻执行 f(args...)，返回定时器句柄
+  template <typename F, typename... Args>
+  timer_handle spawn_at(std::chrono::steady_clock::time_point when, F&& f,
+                        Args&&... args) {
+    return _pool->submit_at(when, std::forward<F>(f),
+                            std::forward<Args>(args)...);
+  }
+
+  // 每隔 period 执行一次 f(args...)，直到取消或线程池关闭
+  template <typename Rep, typename Period, typename F, typename... Args>
+  timer_handle spawn_every(std::chrono::duration<Rep, Period> period, F&& f,
+                           Args&&... args) {
+    return _pool->submit_every(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(period),
+        std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 执行协程任务，返回获取结果的 future
+  template <typename T>
+  std::future<T> co_spawn(task<T> t) {
+    return _pool->co_spawn(std::move(t));
+  }
+
+  // fd 可读时执行 f(args...)(一次性)，返回future
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> on_readable(int fd, F&& f,
+                                                            Args&&... args) {
+    return _pool->submit_on_ready(fd, detail::Readiness::readable,
+                                  std::forward<F>(f),
+                                  std::forward<Args>(args)...);
+  }
+
+  // fd 可写时执行 f(args...)(一次性)，返回future
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> on_writable(int fd, F&& f,
+                                                            Args&&... args) {
+    return _pool->submit_on_ready(fd, detail::Readiness::writable,
+                                  std::forward<F>(f),
+                                  std::forward<Args>(args)...);
+  }
+
+  // 在协程中等待 fd 可读
+  auto readable(int fd) {
+    return _pool->wait_ready(fd, detail::Readiness::readable);
+  }
+
+  // 在协程中等待 fd 可写
+  auto writable(int fd) {
+    return _pool->wait_ready(fd, detail::Readiness::writable);
+  }
+
+  // 停止监听 fd 并唤醒 fd 上所有等待者，关闭 fd 之前调用
+  void release_fd(int fd) { _pool->release_fd(fd); }
+
+  // 分配文件读写缓冲区
+  io_buffer acquire_buffer() { return _pool->acquire_buffer(); }
+
+  // 在协程中读取文件，返回读取的字节数，失败时为 -errno
+  auto read_at(int fd, std::span<std::byte> buf, std::uint64_t offset) {
+    return _pool->read_at(fd, buf, offset);
+  }
+
+  // 在协程中写入文件，返回写入的字节数，失败时为 -errno
+  auto write_at(int fd, std::span<const std::byte> buf, std::uint64_t offset) {
+    return _pool->write_at(fd, buf, offset);
+  }
+
+  // 读取文件，完成后执行 f(读取的字节数或 -errno)，返回future
+  template <typename F>
+  std::future<std::invoke_result_t<F, std::int64_t>> read_at(
+      int fd, std::span<std::byte> buf, std::uint64_t offset, F&& f) {
+    return _pool->read_at(fd, buf, offset, std::forward<F>(f));
+  }
+
+  // 写入文件，完成后执行 f(写入的字节数或 -errno)，返回future
+  template <typename F>
+  std::future<std::invoke_result_t<F, std::int64_t>> write_at(
+      int fd, std::span<const std::byte> buf, std::uint64_t offset, F&& f) {
+    return _pool->write_at(fd, buf, offset, std::forward<F>(f));
+  }
+
+  // 创建会阻塞线程的异步任务，在阻塞任务线程集合中执行
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<F, Args...>> spawn_blocking(
+      F&& f, Args&&... args) {
+    return _pool->submit_blocking(std::forward<F>(f),
+                                  std::forward<Args>(args)...);
+  }
+
+  // 批量创建异步任务：对 range 中每个元素调用 f，整批任务一次入队
+  // f 在整批任务间共享并发调用，必须可以通过 const 引用调用
+  template <std::ranges::input_range R, typename F>
+    requires std::invocable<const std::decay_t<F>&,
+                            std::ranges::range_value_t<R>&>
+  auto spawn_batch(R&& range, F&& f) {
+    return _pool->submit_batch(std::forward<R>(range), std::forward<F>(f));
+  }
+
+  // 批量创建 n 个异步任务：依次调用 f(0) ... f(n - 1)
+  template <typename F>
+  auto spawn_n(std::size_t n, F&& f) {
+    return spawn_batch(std::views::iota(std::size_t{0}, n),
+                       std::forward<F>(f));
+  }
+
+  // 阻塞一个任务，等待他及其所有子任务完成
+  template <typename F, typename... Args>
+  void block_on(F&& f, Args&&... args) {
+    _pool->block_on(std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // 主动关闭线程池并且等待线程回收(执行完排队中的任务)
+  void close_and_join() { _pool->shutdown(); }
+
+  // 按 mode 关闭线程池并等待线程退出，之后可以用 restart 重新启动
+  void shutdown(shutdown_mode mode = shutdown_mode::drain) {
+    _pool->shutdown(mode);
   }
 
-  // 5. 阻塞等待记分牌归零
-  // 此时主线程会在这里挂起，直到所有关联了该
-  // group的任务（包括子任务）全部执行完毕。
-  group->wait();
+  // 关闭线程池，最多等待 timeout 执行排队中的任务，超时后丢弃剩余的任务
+  // 返回排队中的任务是否都执行完
+  bool shutdown(std::chrono::milliseconds timeout) {
+    return _pool->shutdown(timeout);
+  }
+
+  // 重新启动已经关闭的线程池，线程数为关闭前的线程数
+  void restart() { _pool->restart(); }
+
+  // 工作线程数
+  [[nodiscard]]
+  std::size_t worker_threads() const {
+    return _pool->thread_num();
+  }
+
+  // 把工作线程数调整为 n(1 到 max_worker_threads)
+  // 减少时被移除的 worker 把排队的任务交还给线程池后退出，不等待它们
+  void resize(std::size_t n) { _pool->resize(n); }
+
+  // resize 可以调整到的最大工作线程数
+  [[nodiscard]]
+  std::size_t max_worker_threads() const {
+    return _pool->max_thread_num();
+  }
+
+  // 活跃的 worker 数量，开启动态伸缩时在 min_active 和工作线程数之间变化
+  [[nodiscard]]
+  std::size_t active_workers() const {
+    return _pool->active_worker_count();
+  }
+
+  // 错过截止时间的任务数量
+  [[nodiscard]]
+  std::size_t missed_deadlines() const {
+    return _pool->missed_deadlines();
+  }
+
+  // 全局队列满时各溢出策略生效的次数
+  [[nodiscard]]
+  overflow_counters overflow_stats() const {
+    return _pool->overflow_stats();
+  }
+
+ private:
+  explicit basic_runtime(detail::PoolOptions options)
+      : _pool(std::make_unique<detail::basic_thread_pool<Policy>>(
+            std::move(options))) {}
+
+ private:
+  std::unique_ptr<detail::basic_thread_pool<Policy>> _pool;
+};
+
+template <detail::SchedulerPolicy Policy>
+basic_runtime<Policy> runtime_builder::build() const {
+  return basic_runtime<Policy>{_options};
 }
+
+// worker 局部存储：线程池的每个 worker 一个缓存行对齐的 T，按 worker id 索引
+// 任务中用 local() 取得当前 worker 的元素，不加锁地累加或复用为缓冲区；
+// 并行阶段结束后用 combine / for_each 汇总所有元素
+// 不是 worker 的线程也各有一个元素(加锁查找)
+template <typename T>
+class worker_local : public detail::WorkerLocal<T> {
+ public:
+  // 默认线程池的 worker 局部存储，init 构造每个元素的初始值
+  explicit worker_local(std::function<T()> init = [] { return T{}; })
+      : detail::WorkerLocal<T>(
+            __inner::_fastexec_inner_thread_pool.scheduler(),
+            __inner::_fastexec_inner_thread_pool.max_thread_num(),
+            std::move(init)) {}
+
+  // runtime 的 worker 局部存储，需要在 runtime 之前销毁
+  template <detail::SchedulerPolicy Policy>
+  explicit worker_local(const basic_runtime<Policy>& rt,
+                        std::function<T()> init = [] { return T{}; })
+      : detail::WorkerLocal<T>(rt._pool->scheduler(),
+                               rt._pool->max_thread_num(), std::move(init)) {}
+};
 }  // namespace fastexec
 
 #endif